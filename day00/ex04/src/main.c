@@ -10,14 +10,18 @@
 /*                                                                            */
 /* ************************************************************************** */
 
+#include "pin.h"
 #include <avr/io.h>
 #include <util/delay.h>
 
+// the leds of the bar, bit 3 of the value lands on PB4
+static const PinGroup led_bar PROGMEM = PIN_GROUP(B, PB0, PB1, PB2, PB4);
+
 int main(void) {
-        // We start by setting the pins of PORTB (1,2,3,4) to output
-        DDRB |= (1 << PB0) | (1 << PB1) | (1 << PB2) | (1 << PB4);
+        // We start by setting the pins of the led bar to output
+        pin_group_output(&led_bar);
         // We make sure to clear their values
-        PORTB &= ~((1 << PB0) | (1 << PB1) | (1 << PB2) | (1 << PB4));
+        pin_group_write(&led_bar, 0);
 
         // we then configure PORTD to read from sw1 sw2
         DDRD &= ~((1 << PD2) | (1 << PD4));
@@ -55,14 +59,8 @@ int main(void) {
                 prev_sw1 = curr_sw1;
                 prev_sw2 = curr_sw2;
 
-                // we update the values of the led
-                uint8_t led_val = 0;
-                led_val |= (value & 0x07);
-                if (value & 0x08) { // overflow protection
-                        led_val |= (1 << PB4);
-                }
-                // we then write to the leds
-                PORTB = (PORTB & ~((1 << PB0) | (1 << PB1) | (1 << PB2) | (1 << PB4))) | led_val;
+                // we then write the low 4 bits of the value to the leds
+                pin_group_write(&led_bar, value);
 
                 // and add a small delay
                 _delay_ms(10);
@@ -1,4 +1,5 @@
 #include "hal.h"
+#include "soft_timer.h"
 #include <avr/delay.h>
 #include <avr/interrupt.h>
 
@@ -16,18 +17,11 @@ void uart_printstr(const char *str) {
         }
 }
 
-volatile uint8_t interrupt_counter = 0;
-
-
-ISR(TIMER1_COMPA_vect) {
-        if (interrupt_counter == 1) {
-                // this ensure that we only call the function
-                // every 2 interrupt aka every 2s.
-                uart_printstr("Hello World!\n");
-                interrupt_counter = 0;
-        } else {
-                interrupt_counter = 1;
-        }
+// runs from soft_timer_poll() in the main loop, so the blocking print never
+// delays an interrupt. the wheel can carry any number of other timers.
+static void say_hello(void *ctx) {
+        (void)ctx;
+        uart_printstr("Hello World!\n");
 }
 
 
@@ -46,13 +40,12 @@ int main(void) {
         // configure the pin pd1 (aka TX) as output.
         DDRD |= (1 << PD1);
 
-        TCCR1B |= (1 << WGM12);  // CTC mode.
-        OCR1A = 62499;           // we set OCR1A to 1hz.
-        TIMSK1 |= (1 << OCIE1A); // enable the timer1 ctc interrupt
-        TCCR1B |= (1 << CS12);   // configure the prescaler to 256
-
-        sei(); // we enable gloabl interrups to enable the ISR macro.
+        // timer1 now provides the millisecond clock, the 2s period is a software timer.
+        clock_init();
+        static SoftTimer hello;
+        soft_timer_start(&hello, 2000, 2000, say_hello, 0);
 
         loop {
+                soft_timer_poll();
         }
 }
@@ -1,34 +1,31 @@
 #include "hal.h"
+#include "pin.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
-// global variable declarations for hardware pin objects.
-// 'd1' represents the led connected to port b, pin 0 (pb0).
-// 'sw1' represents the push-button connected to port d, pin 2 (pd2).
-GpioPin d1;
-GpioPin sw1;
+// compile-time pin names, every access below is a single instruction.
+// 'D1' is the led connected to port b, pin 0 (pb0).
+// 'SW1' is the push-button connected to port d, pin 2 (pd2).
+#define D1  B, PB0
+#define SW1 D, PD2
 
 // interrupt service routine for external interrupt 0 (int0).
 // this routine executes automatically when int0 is triggered.
 // the interrupt is configured to detect a falling edge (high-to-low transition) on pd2.
-// when triggered, it toggles the state of the led associated with 'd1'.
+// when triggered, it toggles the state of the led associated with 'D1'.
 ISR(INT0_vect) {
-        gpio_toggle(&d1); // toggle led: if it's on, turn it off; if it's off, turn it on.
+        pin_toggle(D1); // toggle led: writing its bit to PINB flips it, no read-modify-write.
 }
 
 int main(void) {
         // initialize the led hardware:
-        // link the 'd1' object to port b, pin 0 (pb0).
-        // configure the pin as an output to drive the led.
-        gpio_init(&d1, GPIO_PORTB, PB0);
-        gpio_set_output(&d1);
+        // configure pb0 as an output to drive the led.
+        pin_output(D1);
 
         // initialize the push-button hardware:
-        //  link the 'sw1' object to port d, pin 2 (pd2).
-        //  configure the pin as an input and enable its internal pull-up resistor.
+        //  configure pd2 as an input and enable its internal pull-up resistor.
         //   this ensures the input is high by default and goes low when the button is pressed.
-        gpio_init(&sw1, GPIO_PORTD, PD2);
-        gpio_set(&sw1); // enable internal pull-up resistor for reliable button state reading.
+        pin_pullup(SW1);
 
         // configure external interrupt int0 to detect a falling edge:
         //  modify the external interrupt control register a (eicra):
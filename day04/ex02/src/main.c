@@ -1,4 +1,5 @@
 #include "hal.h"
+#include "pin.h"
 #include <avr/io.h>
 #include <avr/interrupt.h>
 #include <util/delay.h>
@@ -13,6 +14,9 @@ volatile uint8_t value = 0;
 volatile uint8_t prev_sw1;
 volatile uint8_t prev_sw2;
 
+// the four leds of the bar: value bits 0 to 2 on pb0-pb2, bit 3 on pb4.
+static const PinGroup led_bar PROGMEM = PIN_GROUP(B, PB0, PB1, PB2, PB4);
+
 // timer0 compare match a interrupt service routine (isr):
 // this function is executed every time timer0 reaches the value defined in ocr0a,
 // effectively creating a periodic interrupt (approximately every 10ms).
@@ -46,21 +50,10 @@ ISR(TIMER0_COMPA_vect) {
         prev_sw1 = curr_sw1;
         prev_sw2 = curr_sw2;
 
-        // prepare the value to be displayed on the leds:
-        // the lower three bits of 'value' (bits 0 to 2) will be displayed on leds connected to pb0, pb1, and pb2.
-        uint8_t led_val = (value & 0x07);
-
-        // check the most significant bit (bit 3) of 'value':
-        // if bit 3 is set, it indicates the value is 8 or higher.
-        // in that case, light an additional led connected to pb4.
-        if (value & 0x08) {
-                led_val |= (1 << PB4); // set the bit corresponding to pb4 in 'led_val'.
-        }
-
-        // update the led outputs on portb:
-        // first, clear the bits for pb0, pb1, pb2, and pb4 in portb to remove old led values.
-        // then, set these bits to the new 'led_val' to reflect the current 'value'.
-        PORTB = (PORTB & ~((1 << PB0) | (1 << PB1) | (1 << PB2) | (1 << PB4))) | led_val;
+        // display the low 4 bits of 'value' on the led bar:
+        // the group's table already holds the portb bits for every value, bit 3 included,
+        // so this is a single store that leaves the other portb pins alone.
+        pin_group_write(&led_bar, value);
 
         // insert an additional short delay (10ms) to provide extra stabilization (optional).
         _delay_ms(10);
@@ -69,9 +62,9 @@ ISR(TIMER0_COMPA_vect) {
 int main(void) {
         // configure led output pins on portb:
         // set pb0, pb1, pb2, and pb4 as outputs because these pins are used to display the counter value.
-        DDRB |= (1 << PB0) | (1 << PB1) | (1 << PB2) | (1 << PB4);
+        pin_group_output(&led_bar);
         // initialize the led pins to low (off) by clearing them.
-        PORTB &= ~((1 << PB0) | (1 << PB1) | (1 << PB2) | (1 << PB4));
+        pin_group_write(&led_bar, 0);
 
         // configure switch input pins on portd:
         // clear the ddrd bits for pd2 and pd4 to configure these pins as inputs.
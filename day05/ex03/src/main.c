@@ -1,36 +1,15 @@
 #include "hal.h"
+#include "libc.h"
 #include <avr/io.h>
 #include <util/delay.h>
 #include <stdint.h>
 
-// uart initialization
-void uart_init() {
-        UBRR0H = 0;
-        UBRR0L = 8;
-        UCSR0B = (1 << TXEN0);
-        UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
-}
-
-// uart putchar function
-void uart_putchar(u8 c) {
-        loop_until_bit_is_set(UCSR0A, UDRE0);
-        UDR0 = c;
-}
-
-// print a string without newline
-void uart_print(const u8 *str) {
-        if (!str) return;
-        while (*str) {
-                uart_putchar(*str++);
-        }
-}
+#ifndef TELEMETRY
+#define TELEMETRY 0
+#endif
 
-// print a string with CR+LF at the end
-void uart_println(const u8 *str) {
-        uart_print(str);
-        uart_putchar('\r');
-        uart_putchar('\n');
-}
+// frame type of a reading: raw ADC value then tenths of a degree, both little endian
+#define FRAME_TEMPERATURE 0x01
 
 // adc initialization for internal temperature sensor
 void adc_init() {
@@ -50,30 +29,22 @@ i16 adc_to_celsius(u16 adc_value) {
         return ((adc_value * 100) - 3243) / 122; // integer math approximation
 }
 
-// convert integer temperature (e.g., 253) to string "25.3"
-void fmt_temp(u8 *buffer, i16 temperature) {
-        u8 whole   = temperature / 10;
-        u8 decimal = temperature % 10;
-        buffer[0]  = '0' + (whole / 10);
-        buffer[1]  = '0' + (whole % 10);
-        buffer[2]  = '.';
-        buffer[3]  = '0' + decimal;
-        buffer[4]  = '\0';
-}
-
 int main(void) {
-        uart_init();
+        UartOption opts = {.baud_rate = 115200, .transmit = true};
+        uart_init(&opts);
         adc_init();
 
-        u8 buf_temp[6];
-
         while (1) {
                 u16 adc_value   = adc_read_temp();
                 i16 temperature = adc_to_celsius(adc_value);
-                fmt_temp(buf_temp, temperature);
 
-                uart_print((u8 *)"Temp: ");
-                uart_println(buf_temp);
+#if TELEMETRY
+                i16 reading[2] = {adc_value, temperature};
+                uart_frame_send(FRAME_TEMPERATURE, reading, sizeof(reading));
+#else
+                // tenths of a degree printed as fixed point, e.g. 253 -> "25.3"
+                uart_printf_F("Temp: %.1d\r\n", temperature);
+#endif
                 _delay_ms(20);
         }
 
@@ -1,4 +1,5 @@
 #include "hal.h"
+#include "pin.h"
 #include <avr/io.h>
 #include <util/delay.h>
 #include <stdint.h>
@@ -13,7 +14,7 @@
 #define RGB_GREEN PD6
 #define RGB_BLUE  PD3
 
-#define LED_MASK  ((1 << LED_D1) | (1 << LED_D2) | (1 << LED_D3) | (1 << LED_D4))
+static const PinGroup led_bar PROGMEM = PIN_GROUP(B, LED_D1, LED_D2, LED_D3, LED_D4);
 
 void adc_init() {
         ADMUX  = (1 << REFS0);
@@ -27,16 +28,13 @@ uint16_t adc_read() {
 }
 
 void led_init() {
-        DDRB |= LED_MASK; // set only led pins as output
+        pin_group_output(&led_bar); // set only led pins as output
 }
 
 void led_gauge(uint16_t adc_value) {
-        PORTB &= ~LED_MASK;
-
-        if (adc_value >= 256) PORTB |= (1 << LED_D1);
-        if (adc_value >= 512) PORTB |= (1 << LED_D2);
-        if (adc_value >= 768) PORTB |= (1 << LED_D3);
-        if (adc_value >= 1010) PORTB |= (1 << LED_D4);
+        uint8_t level = (adc_value >= 256) + (adc_value >= 512) + (adc_value >= 768) + (adc_value >= 1010);
+        // one store for the whole bar, so it never shows a partly updated gauge
+        pin_group_write(&led_bar, (1 << level) - 1);
 }
 
 void pwm_init(void) {
@@ -1,5 +1,6 @@
 #include "hal.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 #include <util/twi.h>
 
@@ -9,63 +10,64 @@
 
 #define i2c_status()           (TWSR & 0xF8)
 
-u8 *i2c_return_code_desc(u8 status_code) {
+// descriptions live in flash, print them with uart_println_P
+PGM_P i2c_return_code_desc(u8 status_code) {
         if (status_code == TW_START)
-                return (u8 *)("START acknowledge.");
+                return PSTR("START acknowledge.");
         else if (status_code == TW_REP_START)
-                return (u8 *)("REPEATED START acknowledge.");
+                return PSTR("REPEATED START acknowledge.");
         else if (status_code == TW_MT_SLA_ACK)
-                return (u8 *)("Master Transmitter: Slave ACK");
+                return PSTR("Master Transmitter: Slave ACK");
         else if (status_code == TW_MT_SLA_NACK)
-                return (u8 *)("Master Transmitter : Slave NACK");
+                return PSTR("Master Transmitter : Slave NACK");
         else if (status_code == TW_MT_DATA_ACK)
-                return (u8 *)("Master Transmitter : Data ACK");
+                return PSTR("Master Transmitter : Data ACK");
         else if (status_code == TW_MT_DATA_NACK)
-                return (u8 *)("Master Transmitter: Data NACK");
+                return PSTR("Master Transmitter: Data NACK");
         else if (status_code == TW_MR_SLA_ACK)
-                return (u8 *)("Master Receiver : Slave ACK");
+                return PSTR("Master Receiver : Slave ACK");
         else if (status_code == TW_MR_SLA_NACK)
-                return (u8 *)("Master Receiver : Slave NACK");
+                return PSTR("Master Receiver : Slave NACK");
         else if (status_code == TW_MR_DATA_ACK)
-                return (u8 *)("Master Receiver : Data ACK");
+                return PSTR("Master Receiver : Data ACK");
         else if (status_code == TW_MR_DATA_NACK)
-                return (u8 *)("Master Receiver : Data NACK");
+                return PSTR("Master Receiver : Data NACK");
         else if (status_code == TW_MT_ARB_LOST || status_code == TW_MR_ARB_LOST)
-                return (u8 *)("Arbitration Lost");
+                return PSTR("Arbitration Lost");
         else if (status_code == TW_ST_SLA_ACK)
-                return (u8 *)("Slave Transmitter : Slave ACK");
+                return PSTR("Slave Transmitter : Slave ACK");
         else if (status_code == TW_ST_ARB_LOST_SLA_ACK)
-                return (u8 *)("Arbitration Lost in SLA+R/W, Slave ACK");
+                return PSTR("Arbitration Lost in SLA+R/W, Slave ACK");
         else if (status_code == TW_ST_DATA_ACK)
-                return (u8 *)("Slave Transmitter : Data ACK");
+                return PSTR("Slave Transmitter : Data ACK");
         else if (status_code == TW_ST_DATA_NACK)
-                return (u8 *)("Slave Transmitter : Data NACK");
+                return PSTR("Slave Transmitter : Data NACK");
         else if (status_code == TW_ST_LAST_DATA)
-                return (u8 *)("Slave Transmitter : Last Data");
+                return PSTR("Slave Transmitter : Last Data");
         else if (status_code == TW_SR_SLA_ACK)
-                return (u8 *)("Slave Receiver : Slave ACK");
+                return PSTR("Slave Receiver : Slave ACK");
         else if (status_code == TW_SR_ARB_LOST_SLA_ACK)
-                return (u8 *)("Arbitration Lost in SLA+R/W, Slave ACK");
+                return PSTR("Arbitration Lost in SLA+R/W, Slave ACK");
         else if (status_code == TW_SR_GCALL_ACK)
-                return (u8 *)("General Call : Slave ACK");
+                return PSTR("General Call : Slave ACK");
         else if (status_code == TW_SR_ARB_LOST_GCALL_ACK)
-                return (u8 *)("Arbitration Lost in General Call, Slave ACK");
+                return PSTR("Arbitration Lost in General Call, Slave ACK");
         else if (status_code == TW_SR_DATA_ACK)
-                return (u8 *)("Slave Receiver : Data ACK");
+                return PSTR("Slave Receiver : Data ACK");
         else if (status_code == TW_SR_DATA_NACK)
-                return (u8 *)("Slave Receiver : Data NACK");
+                return PSTR("Slave Receiver : Data NACK");
         else if (status_code == TW_SR_GCALL_DATA_ACK)
-                return (u8 *)("General Call : Data ACK");
+                return PSTR("General Call : Data ACK");
         else if (status_code == TW_SR_GCALL_DATA_NACK)
-                return (u8 *)("General Call : Data NACK");
+                return PSTR("General Call : Data NACK");
         else if (status_code == TW_SR_STOP)
-                return (u8 *)("Slave Receiver : STOP received");
+                return PSTR("Slave Receiver : STOP received");
         else if (status_code == TW_NO_INFO)
-                return (u8 *)("No state information available");
+                return PSTR("No state information available");
         else if (status_code == TW_BUS_ERROR)
-                return (u8 *)("Bus Error");
+                return PSTR("Bus Error");
         else
-                return (u8 *)("Unknown Status Code");
+                return PSTR("Unknown Status Code");
 }
 
 // uart initialization
@@ -93,6 +95,17 @@ void uart_println(const u8 *str) {
         uart_putchar('\n');
 }
 
+// print a string stored in flash with cr+lf at the end
+void uart_println_P(PGM_P str) {
+        if (!str) return;
+        u8 c;
+        while ((c = pgm_read_byte(str++))) {
+                uart_putchar(c);
+        }
+        uart_putchar('\r');
+        uart_putchar('\n');
+}
+
 // function to print a byte in hex format via uart
 void print_hex_value(u8 c) {
         u8 hex_chars[] = "0123456789ABCDEF";
@@ -103,7 +116,7 @@ void print_hex_value(u8 c) {
 
 void i2c_debug() {
 #ifdef DEBUG
-        uart_println(i2c_return_code_desc(i2c_status()));
+        uart_println_P(i2c_return_code_desc(i2c_status()));
 #endif
 }
 
@@ -1,121 +1,84 @@
 #include "hal.h"
+#include "libc.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
-#include <stdlib.h>
 #include <util/twi.h>
 
 #define I2C_ADDRESS_AHT20      (0x38 << 1)
 #define MEASUREMENT_CMD        0xAC
 #define DELAY_BETWEEN_READS_MS 1000
 
-static float humidity_buffer[3]    = {0};
-static float temperature_buffer[3] = {0};
-static u8    measurement_count     = 0;
+// readings in tenths of a percent and of a degree Celsius
+static i16 humidity_buffer[3]    = {0};
+static i16 temperature_buffer[3] = {0};
+static u8  measurement_count     = 0;
 
 #define i2c_status() (TWSR & 0xF8)
 
-u8 *i2c_return_code_desc(u8 status_code) {
+// descriptions live in flash, print them with uart_putline_P
+PGM_P i2c_return_code_desc(u8 status_code) {
         if (status_code == TW_START)
-                return (u8 *)("START acknowledge.");
+                return PSTR("START acknowledge.");
         else if (status_code == TW_REP_START)
-                return (u8 *)("REPEATED START acknowledge.");
+                return PSTR("REPEATED START acknowledge.");
         else if (status_code == TW_MT_SLA_ACK)
-                return (u8 *)("Master Transmitter: Slave ACK");
+                return PSTR("Master Transmitter: Slave ACK");
         else if (status_code == TW_MT_SLA_NACK)
-                return (u8 *)("Master Transmitter : Slave NACK");
+                return PSTR("Master Transmitter : Slave NACK");
         else if (status_code == TW_MT_DATA_ACK)
-                return (u8 *)("Master Transmitter : Data ACK");
+                return PSTR("Master Transmitter : Data ACK");
         else if (status_code == TW_MT_DATA_NACK)
-                return (u8 *)("Master Transmitter: Data NACK");
+                return PSTR("Master Transmitter: Data NACK");
         else if (status_code == TW_MR_SLA_ACK)
-                return (u8 *)("Master Receiver : Slave ACK");
+                return PSTR("Master Receiver : Slave ACK");
         else if (status_code == TW_MR_SLA_NACK)
-                return (u8 *)("Master Receiver : Slave NACK");
+                return PSTR("Master Receiver : Slave NACK");
         else if (status_code == TW_MR_DATA_ACK)
-                return (u8 *)("Master Receiver : Data ACK");
+                return PSTR("Master Receiver : Data ACK");
         else if (status_code == TW_MR_DATA_NACK)
-                return (u8 *)("Master Receiver : Data NACK");
+                return PSTR("Master Receiver : Data NACK");
         else if (status_code == TW_MT_ARB_LOST || status_code == TW_MR_ARB_LOST)
-                return (u8 *)("Arbitration Lost");
+                return PSTR("Arbitration Lost");
         else if (status_code == TW_ST_SLA_ACK)
-                return (u8 *)("Slave Transmitter : Slave ACK");
+                return PSTR("Slave Transmitter : Slave ACK");
         else if (status_code == TW_ST_ARB_LOST_SLA_ACK)
-                return (u8 *)("Arbitration Lost in SLA+R/W, Slave ACK");
+                return PSTR("Arbitration Lost in SLA+R/W, Slave ACK");
         else if (status_code == TW_ST_DATA_ACK)
-                return (u8 *)("Slave Transmitter : Data ACK");
+                return PSTR("Slave Transmitter : Data ACK");
         else if (status_code == TW_ST_DATA_NACK)
-                return (u8 *)("Slave Transmitter : Data NACK");
+                return PSTR("Slave Transmitter : Data NACK");
         else if (status_code == TW_ST_LAST_DATA)
-                return (u8 *)("Slave Transmitter : Last Data");
+                return PSTR("Slave Transmitter : Last Data");
         else if (status_code == TW_SR_SLA_ACK)
-                return (u8 *)("Slave Receiver : Slave ACK");
+                return PSTR("Slave Receiver : Slave ACK");
         else if (status_code == TW_SR_ARB_LOST_SLA_ACK)
-                return (u8 *)("Arbitration Lost in SLA+R/W, Slave ACK");
+                return PSTR("Arbitration Lost in SLA+R/W, Slave ACK");
         else if (status_code == TW_SR_GCALL_ACK)
-                return (u8 *)("General Call : Slave ACK");
+                return PSTR("General Call : Slave ACK");
         else if (status_code == TW_SR_ARB_LOST_GCALL_ACK)
-                return (u8 *)("Arbitration Lost in General Call, Slave ACK");
+                return PSTR("Arbitration Lost in General Call, Slave ACK");
         else if (status_code == TW_SR_DATA_ACK)
-                return (u8 *)("Slave Receiver : Data ACK");
+                return PSTR("Slave Receiver : Data ACK");
         else if (status_code == TW_SR_DATA_NACK)
-                return (u8 *)("Slave Receiver : Data NACK");
+                return PSTR("Slave Receiver : Data NACK");
         else if (status_code == TW_SR_GCALL_DATA_ACK)
-                return (u8 *)("General Call : Data ACK");
+                return PSTR("General Call : Data ACK");
         else if (status_code == TW_SR_GCALL_DATA_NACK)
-                return (u8 *)("General Call : Data NACK");
+                return PSTR("General Call : Data NACK");
         else if (status_code == TW_SR_STOP)
-                return (u8 *)("Slave Receiver : STOP received");
+                return PSTR("Slave Receiver : STOP received");
         else if (status_code == TW_NO_INFO)
-                return (u8 *)("No state information available");
+                return PSTR("No state information available");
         else if (status_code == TW_BUS_ERROR)
-                return (u8 *)("Bus Error");
+                return PSTR("Bus Error");
         else
-                return (u8 *)("Unknown Status Code");
-}
-
-// uart initialization
-void uart_init() {
-        UBRR0H = 0;
-        UBRR0L = 8; // baud rate for 115200 with 16mhz clock
-        UCSR0B = (1 << TXEN0);
-        UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
-}
-
-// uart putu8 function
-void uart_putchar(u8 c) {
-        loop_until_bit_is_set(UCSR0A, UDRE0);
-        UDR0 = c;
-}
-
-
-// print a string with cr+lf at the end
-void uart_println(const u8 *str) {
-        if (!str) return;
-        while (*str) {
-                uart_putchar(*str++);
-        }
-        uart_putchar('\r');
-        uart_putchar('\n');
-}
-
-void uart_print(const u8 *str) {
-        if (!str) return;
-        while (*str) {
-                uart_putchar(*str++);
-        }
-}
-
-// function to print a byte in hex format via uart
-void print_hex_value(u8 c) {
-        u8 hex_chars[] = "0123456789ABCDEF";
-        uart_putchar(hex_chars[(c >> 4) & 0x0F]); // print high nibble
-        uart_putchar(hex_chars[c & 0x0F]);        // print low nibble
-        uart_putchar(' ');                        // space for readability
+                return PSTR("Unknown Status Code");
 }
 
 void i2c_debug() {
 #ifdef DEBUG
-        uart_println(i2c_return_code_desc(i2c_status()));
+        uart_putline_P(i2c_return_code_desc(i2c_status()));
 #endif
 }
 
@@ -170,7 +133,7 @@ void i2c_read(void) {
 
         // print the received data
         for (u8 i = 0; i < 7; i++) {
-                print_hex_value(data[i]);
+                PRINT(HEX2(data[i]), CHR(' '));
         }
 }
 
@@ -186,7 +149,7 @@ void i2c_init() {
 
 
 // function to shift and store new values for averaging
-void update_measurement_buffers(float humidity, float temperature) {
+void update_measurement_buffers(i16 humidity, i16 temperature) {
         humidity_buffer[0]    = humidity_buffer[1];
         humidity_buffer[1]    = humidity_buffer[2];
         humidity_buffer[2]    = humidity;
@@ -201,7 +164,7 @@ void update_measurement_buffers(float humidity, float temperature) {
 }
 
 // function to compute average
-void compute_average(float *humidity, float *temperature) {
+void compute_average(i16 *humidity, i16 *temperature) {
         u8 count     = (measurement_count < 3) ? measurement_count : 3;
         *humidity    = (humidity_buffer[0] + humidity_buffer[1] + humidity_buffer[2]) / count;
         *temperature = (temperature_buffer[0] + temperature_buffer[1] + temperature_buffer[2]) / count;
@@ -209,8 +172,8 @@ void compute_average(float *humidity, float *temperature) {
 
 // function to read aht20 sensor data and compute values
 void i2c_read_aht20() {
-        u8    data[7];
-        float humidity, temperature;
+        u8  data[7];
+        i16 humidity, temperature;
 
         i2c_start();
         i2c_write(I2C_ADDRESS_AHT20 | 0x01);
@@ -221,30 +184,23 @@ void i2c_read_aht20() {
         i2c_stop();
 
         // convert raw data to temperature and humidity values
-        u32 raw_humidity    = ((u32)data[1] << 16) | ((u32)data[2] << 8) | data[3];
+        u32 raw_humidity    = ((u32)data[1] << 12) | ((u32)data[2] << 4) | (data[3] >> 4);
         u32 raw_temperature = ((u32)(data[3] & 0x0F) << 16) | ((u32)data[4] << 8) | data[5];
-        humidity            = ((float)raw_humidity * 10.0) / 1048576.0;            // precomputed values
-        temperature         = ((float)raw_temperature * 200.0) / 1048576.0 - 50.0; // precomputed values
+        // RH = raw / 2^20 * 100% and T = raw / 2^20 * 200 - 50 C, kept in tenths and rounded
+        humidity            = (raw_humidity * 1000 + (1UL << 19)) >> 20;
+        temperature         = (i16)((raw_temperature * 2000 + (1UL << 19)) >> 20) - 500;
 
         update_measurement_buffers(humidity, temperature);
 
         // compute the average of the last three readings
         compute_average(&humidity, &temperature);
 
-        char buffer[10];
-        dtostrf(temperature, 5, 1, buffer);
-        uart_print((u8 *)"Temperature: ");
-        uart_print((u8 *)buffer);
-        uart_print((u8 *)" C ");
-
-        dtostrf(humidity, 5, 1, buffer);
-        uart_print((u8 *)"Humidity: ");
-        uart_print((u8 *)buffer);
-        uart_print((u8 *)"%");
+        uart_printf_F("Temperature: %5.1d C Humidity: %5.1d%%", temperature, humidity);
 }
 
 int main() {
-        uart_init();
+        UartOption opts = {.baud_rate = 115200, .transmit = true};
+        uart_init(&opts);
         i2c_init();
 
         while (1) {
@@ -260,8 +216,7 @@ int main() {
 
                 i2c_read_aht20();
 
-                uart_putchar('\r');
-                uart_putchar('\n');
+                uart_printf_F("\r\n");
 
                 _delay_ms(DELAY_BETWEEN_READS_MS);
         }
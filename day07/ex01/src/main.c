@@ -6,7 +6,7 @@
 #define ArraySize(ptr) (sizeof(ptr) / sizeof(ptr[0]))
 
 void print_has_string(uint16_t address) {
-        uart_printf(" | ");
+        PRINT(FSTR(" | "));
         for (uint16_t i = address; i < address + 16; i++) {
                 uint8_t val = eeprom_read_byte((uint8_t*)(i));
                 if (is_print(val)) {
@@ -15,12 +15,12 @@ void print_has_string(uint16_t address) {
                         uart_putchar('.');
                 }
         }
-        uart_printf("\r\n");
+        PRINT(FSTR("\r\n"));
 }
 
 void eeprom_hexdump(uint16_t highlight_addr) {
         for (uint16_t i = 0; i < EEPROM_SIZE; i += 16) {
-                uart_printf("%08X: ", i);
+                PRINT(HEX8(i), FSTR(": "));
 
                 for (uint8_t j = 0; j < 16; j += 2) {
                         uint16_t addr = i + j;
@@ -28,20 +28,20 @@ void eeprom_hexdump(uint16_t highlight_addr) {
 
                         uint8_t val = eeprom_read_byte((uint8_t*)addr);
                         if (addr == highlight_addr) {
-                                uart_printf("\033[31m"); // Red color
+                                PRINT(FSTR("\033[31m")); // Red color
                         }
-                        uart_printf("%02X", val);
+                        PRINT(HEX2(val));
                         if (addr == highlight_addr) {
-                                uart_printf("\033[0m"); // Reset color
+                                PRINT(FSTR("\033[0m")); // Reset color
                         }
 
                         val = eeprom_read_byte((uint8_t*)addr + 1);
                         if (addr + 1 == highlight_addr) {
-                                uart_printf("\033[31m"); // Red color
+                                PRINT(FSTR("\033[31m")); // Red color
                         }
-                        uart_printf("%02X ", val);
+                        PRINT(HEX2(val), CHR(' '));
                         if (addr + 1 == highlight_addr) {
-                                uart_printf("\033[0m"); // Reset color
+                                PRINT(FSTR("\033[0m")); // Reset color
                         }
                 }
                 print_has_string(i);
@@ -50,43 +50,51 @@ void eeprom_hexdump(uint16_t highlight_addr) {
 
 
 
+/* "ADDR VALUE" in hex parsed in one pass, 0 or the ParseError of the field that failed */
+int16_t parse_write_request(const char* line, uint16_t* addr, uint8_t* value) {
+        int16_t used = parse_u16(line, 16, addr);
+        if (used < 0) return used;
+        if (!is_whitespace(line[used])) return PARSE_NO_DIGITS;
+        line += used;
+
+        used = parse_u8(line, 16, value);
+        if (used < 0) return used;
+        line += used;
+
+        while (is_whitespace(*line)) line++;
+        return *line ? PARSE_NO_DIGITS : 0;
+}
+
 int main() {
-        UartOption opts = {.baud_rate = 8, .transmit = true, .receive = true};
+        UartOption opts = {.baud_rate = 115200, .transmit = true, .receive = true};
         uart_init(&opts);
 
-        uart_printf("EEPROM Write & Dump Tool\r\n");
+        uart_printf_F("EEPROM Write & Dump Tool\r\n");
 
         while (1) {
-                uart_printf("Enter address & value (hex): ");
+                uart_printf_F("Enter address & value (hex): ");
 
                 char input[16];
                 readline_echo_back(input, sizeof(input));
 
-                char* space = string_search_byte(input, ' ');
-                if (!space) {
-                        uart_printf("Invalid format. Use: ADDR VALUE\r\n");
+                uint16_t addr;
+                uint8_t  value;
+                int16_t  status = parse_write_request(input, &addr, &value);
+                if (status == PARSE_NO_DIGITS) {
+                        uart_printf_F("Invalid format. Use: ADDR VALUE\r\n");
                         continue;
                 }
-
-                *space        = '\0'; // Split the string
-                int16_t addr  = parse_number(input, 16);
-                int16_t value = parse_number(space + 1, 16);
-
-                if (addr == -1 || value == -1) {
-                        uart_printf("invalid address");
-                }
-
-                if (addr >= EEPROM_SIZE || value > 0xFF) {
-                        uart_printf("Address out of range or invalid value.\r\n");
+                if (status == PARSE_OVERFLOW || addr >= EEPROM_SIZE) {
+                        uart_printf_F("Address out of range or invalid value.\r\n");
                         continue;
                 }
 
                 uint8_t current_value = eeprom_read_byte((uint8_t*)addr);
                 if (current_value != value) {
                         eeprom_write_byte((uint8_t*)addr, (uint8_t)value);
-                        uart_printf("Value written.\r\n");
+                        uart_printf_F("Value written.\r\n");
                 } else {
-                        uart_printf("Value unchanged.\r\n");
+                        uart_printf_F("Value unchanged.\r\n");
                 }
                 eeprom_hexdump(addr);
         }
@@ -8,6 +8,7 @@
 #define MAX_VALUE_SIZE 32
 #define MAX_ENTRY_SIZE (1 + MAX_KEY_SIZE + MAX_VALUE_SIZE)
 
+static const CharSet separators = CHARSET(" \t");
 
 uint16_t find_key(const char* key) {
         uint16_t addr = 0;
@@ -37,44 +38,44 @@ uint16_t find_free_space() {
 void read_command(const char* key) {
         uint16_t addr = find_key(key);
         if (addr == 0xFFFF) {
-                uart_putline("empty");
+                uart_putline_F("empty");
                 return;
         }
         char value[MAX_VALUE_SIZE];
         eeprom_read_block(value, (void*)(addr + 1 + MAX_KEY_SIZE), MAX_VALUE_SIZE);
-        uart_printf("%s\r\n", value);
+        uart_printf_F("%s\r\n", value);
 }
 
 
 void write_command(const char* key, const char* value) {
         if (find_key(key) != 0xFFFF) {
-                uart_putline("already exists");
+                uart_putline_F("already exists");
                 return;
         }
         uint16_t addr = find_free_space();
         if (addr == 0xFFFF) {
-                uart_putline("no space left");
+                uart_putline_F("no space left");
                 return;
         }
         eeprom_write_byte((uint8_t*)addr, MAGIC_NUMBER);
         eeprom_write_block(key, (void*)(addr + 1), MAX_KEY_SIZE);
         eeprom_write_block(value, (void*)(addr + 1 + MAX_KEY_SIZE), MAX_VALUE_SIZE);
-        uart_printf("0x%04X\r\n", addr);
+        uart_printf_F("0x%04X\r\n", addr);
 }
 
 
 void forget_command(const char* key) {
         uint16_t addr = find_key(key);
         if (addr == 0xFFFF) {
-                uart_putline("not found");
+                uart_putline_F("not found");
                 return;
         }
         eeprom_write_byte((uint8_t*)addr, 0x00);
-        uart_putline("deleted");
+        uart_putline_F("deleted");
 }
 
 void print_has_string(uint16_t address) {
-        uart_printf(" | ");
+        PRINT(FSTR(" | "));
         for (uint16_t i = address; i < address + 16; i++) {
                 uint8_t val = eeprom_read_byte((uint8_t*)(i));
                 if (is_print(val)) {
@@ -83,17 +84,17 @@ void print_has_string(uint16_t address) {
                         uart_putchar('.');
                 }
         }
-        uart_printf("\r\n");
+        PRINT(FSTR("\r\n"));
 }
 
 void print_hexdump() {
         for (uint16_t i = 0; i < EEPROM_SIZE; i += 16) {
-                uart_printf("0x%08X: ", i);
+                PRINT(FSTR("0x"), HEX8(i), FSTR(": "));
                 for (uint8_t j = 0; j < 16; j += 2) {
                         uint8_t val = eeprom_read_byte((uint8_t*)(i + j));
-                        uart_printf("%02X", val);
+                        PRINT(HEX2(val));
                         val = eeprom_read_byte((uint8_t*)(i + j + 1));
-                        uart_printf("%02X ", val);
+                        PRINT(HEX2(val), CHR(' '));
                 }
                 print_has_string(i);
         }
@@ -103,49 +104,82 @@ void clear_command(void) {
         for (uint16_t i = 0; i < EEPROM_SIZE; i++) {
                 eeprom_write_byte((uint8_t*)i, 0xFF);
         }
-        uart_putline("EEPROM cleared");
+        uart_putline_F("EEPROM cleared");
+}
+
+/* Argument copied zero padded into dst, false with a message if it does not fit */
+bool take_field(const Span* arg, char* dst, uint8_t size) {
+        if (span_copy(*arg, dst, size) >= 0) return true;
+        uart_putline_F("argument too long");
+        return false;
+}
+
+void read_handler(const Span* args, uint8_t argc) {
+        (void)argc;
+        char key[MAX_KEY_SIZE] = {0};
+        if (take_field(&args[0], key, sizeof(key))) read_command(key);
+}
+
+void write_handler(const Span* args, uint8_t argc) {
+        (void)argc;
+        /* fields are zero padded so whole EEPROM slots can be written from them */
+        char key[MAX_KEY_SIZE]     = {0};
+        char value[MAX_VALUE_SIZE] = {0};
+        if (take_field(&args[0], key, sizeof(key)) && take_field(&args[1], value, sizeof(value))) write_command(key, value);
+}
+
+void forget_handler(const Span* args, uint8_t argc) {
+        (void)argc;
+        char key[MAX_KEY_SIZE] = {0};
+        if (take_field(&args[0], key, sizeof(key))) forget_command(key);
+}
+
+void print_handler(const Span* args, uint8_t argc) {
+        (void)args, (void)argc;
+        print_hexdump();
+}
+
+void clear_handler(const Span* args, uint8_t argc) {
+        (void)args, (void)argc;
+        clear_command();
+}
+
+void help_handler(const Span* args, uint8_t argc);
+
+static const Command commands[] PROGMEM = {
+    {"READ", "<key>", 1, read_handler},
+    {"WRITE", "<key> <value>", 2, write_handler},
+    {"FORGET", "<key>", 1, forget_handler},
+    {"PRINT", "", 0, print_handler},
+    {"CLEAR", "", 0, clear_handler},
+    {"HELP", "", 0, help_handler},
+};
+
+static CommandSet cli;
+
+void help_handler(const Span* args, uint8_t argc) {
+        (void)args, (void)argc;
+        command_help(&cli);
 }
 
 int main() {
-        UartOption opts = {.baud_rate = 8, .transmit = true, .receive = true};
+        UartOption opts = {.baud_rate = 115200, .transmit = true, .receive = true};
         uart_init(&opts);
-        uart_putline("EEPROM Key-Value Store");
+        command_set_init(&cli, commands, COMMAND_COUNT(commands));
+        uart_putline_F("EEPROM Key-Value Store");
+
+        char       input[72];
+        LineEditor editor;
+        line_editor_init(&editor, input, sizeof(input));
+        uart_printf_F("> ");
 
         while (1) {
-                uart_printf("> ");
-                char input[72];
-                readline_echo_back(input, sizeof(input));
-
-                char* cmd = string_tokenize(input, " ");
-                if (!cmd) continue;
-
-                if (string_compare(cmd, "READ") == 0) {
-                        char* key = string_tokenize(NULL, " ");
-                        if (key)
-                                read_command(key);
-                        else
-                                uart_putline("Usage: READ <key>");
-                } else if (string_compare(cmd, "WRITE") == 0) {
-                        char* key   = string_tokenize(NULL, " ");
-                        char* value = string_tokenize(NULL, " ");
-                        if (key && value)
-                                write_command(key, value);
-                        else
-                                uart_putline("Usage: WRITE <key> <value>");
-                } else if (string_compare(cmd, "FORGET") == 0) {
-                        char* key = string_tokenize(NULL, " ");
-                        if (key)
-                                forget_command(key);
-                        else
-                                uart_putline("Usage: FORGET <key>");
-                } else if (string_compare(cmd, "PRINT") == 0) {
-                        print_hexdump();
-                } else if (string_compare(cmd, "CLEAR") == 0) {
-                        clear_command();
-                } else {
-                        uart_putline("Unknown command.");
-                }
-                clear_line(string_length(input));
+                /* only returns a line once Enter was pressed, other work can run in between */
+                int16_t len = line_editor_poll(&editor);
+                if (len < 0) continue;
+
+                if (command_dispatch(&cli, span_make(input, len), &separators) == COMMAND_UNKNOWN) uart_putline_F("Unknown command.");
+                uart_printf_F("> ");
         }
 
         return 0;
@@ -1,5 +1,6 @@
+#include "clock.h"
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/sleep.h>
 
 void spi_init(void) {
         DDRB |= (1 << PB2) | (1 << PB3) | (1 << PB5);
@@ -12,8 +13,29 @@ void spi_cmd(uint8_t data) {
                 ;
 }
 
+// Lights D6 with the given frame, D7 and D8 off.
+void show_color(const uint8_t color[4]) {
+        // Start frame: 4 bytes of 0x00
+        for (uint8_t i = 0; i < 4; i++) spi_cmd(0x00);
+
+        // LED frame for D6: set to the current color.
+        for (uint8_t j = 0; j < 4; j++) spi_cmd(color[j]);
+
+        // LED frames for D7 and D8: off (minimal brightness, colors = 0)
+        for (uint8_t i = 0; i < 2; i++) {
+                spi_cmd(0xE0); // off frame (global brightness minimal)
+                spi_cmd(0x00);
+                spi_cmd(0x00);
+                spi_cmd(0x00);
+        }
+
+        // End frame: 4 bytes of 0xFF (sufficient for 3 LEDs)
+        for (uint8_t i = 0; i < 4; i++) spi_cmd(0xFF);
+}
+
 int main(void) {
         spi_init();
+        clock_init();
 
         // APA102 LED frame format: global brightness, blue, green, red.
         // Use full brightness (0xFF = 0xE0 | 0x1F)
@@ -26,29 +48,21 @@ int main(void) {
             {0xFF, 0xFF, 0x00, 0xFF}, // magenta(R=ff, G=00, B=ff)
             {0xFF, 0xFF, 0xFF, 0xFF}  // white  (R=ff, G=ff, B=ff)
         };
-        uint8_t num_colors = sizeof(colors) / sizeof(colors[0]);
-        uint8_t current    = 0;
+        uint8_t  num_colors = sizeof(colors) / sizeof(colors[0]);
+        uint8_t  current    = 0;
+        uint32_t shown      = millis();
 
+        show_color(colors[current]);
+        set_sleep_mode(SLEEP_MODE_IDLE);
         while (1) {
-                // Start frame: 4 bytes of 0x00
-                for (uint8_t i = 0; i < 4; i++) spi_cmd(0x00);
-
-                // LED frame for D6: set to the current color.
-                for (uint8_t j = 0; j < 4; j++) spi_cmd(colors[current][j]);
-
-                // LED frames for D7 and D8: off (minimal brightness, colors = 0)
-                for (uint8_t i = 0; i < 2; i++) {
-                        spi_cmd(0xE0); // off frame (global brightness minimal)
-                        spi_cmd(0x00);
-                        spi_cmd(0x00);
-                        spi_cmd(0x00);
+                // Change color every second, counted from when the last one was due
+                if (elapsed(shown, 1000)) {
+                        shown  += 1000;
+                        current = (current + 1) % num_colors;
+                        show_color(colors[current]);
                 }
-
-                // End frame: 4 bytes of 0xFF (sufficient for 3 LEDs)
-                for (uint8_t i = 0; i < 4; i++) spi_cmd(0xFF);
-
-                _delay_ms(1000); // Change color every second
-                current = (current + 1) % num_colors;
+                // nothing else to do: idle until the next clock tick wakes us
+                sleep_mode();
         }
 
         return 0;
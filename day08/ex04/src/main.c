@@ -1,7 +1,6 @@
 #include "libc.h"
 #include <avr/io.h>
 #include <util/delay.h>
-#include <string.h>
 
 typedef union {
         uint8_t bytes[3];
@@ -77,75 +76,92 @@ void wheel(uint8_t pos) {
         spi_set_color(c, c, c);
 }
 
-void trim_newline(char *str) {
-        size_t len = strlen(str);
-        while (len > 0 && (str[len - 1] == '\n' || str[len - 1] == '\r')) {
-                str[len - 1] = '\0';
-                len--;
+/* Two hex digits at offset of the command, false if they are not hex */
+bool parse_channel(Span cmd, uint8_t offset, uint8_t *channel) {
+        uint32_t value;
+        if (span_parse_unsigned(span_slice(cmd, offset, 2), 16, &value) != 2) return false;
+        *channel = value;
+        return true;
+}
+
+/* "#RRGGBB" */
+void append_color(StringBuilder *sb, Color c) {
+        string_builder_append_char(sb, '#');
+        string_builder_append_hex(sb, c.r, 2);
+        string_builder_append_hex(sb, c.g, 2);
+        string_builder_append_hex(sb, c.b, 2);
+}
+
+static const CharSet separators = CHARSET(" \t");
+
+void rainbow_handler(const Span *args, uint8_t argc) {
+        (void)args, (void)argc;
+        for (uint16_t i = 0; i < 256; i++) {
+                wheel((uint8_t)i);
+                _delay_ms(20);
         }
 }
 
+void help_handler(const Span *args, uint8_t argc);
+
+static const Command commands[] PROGMEM = {
+    {"#FULLRAINBOW", "", 0, rainbow_handler},
+    {"HELP", "", 0, help_handler},
+};
+
+static CommandSet cli;
+
+void help_handler(const Span *args, uint8_t argc) {
+        (void)args, (void)argc;
+        command_help(&cli);
+        uart_putline_F("#RRGGBBDX");
+}
+
 int main(void) {
         spi_init();
-        char line[MAX_LINE_SIZE];
+        command_set_init(&cli, commands, COMMAND_COUNT(commands));
+        uart_line_mode(true, true);
+        char line[UART_LINE_SIZE];
 
         while (1) {
-                int16_t len = uart_getline(line, MAX_LINE_SIZE);
+                // Lines keep arriving while the rainbow runs, USART_RX_vect queues them
+                int16_t len = uart_take_line(line, sizeof(line));
                 if (len <= 0) continue;
 
-                trim_newline(line);
+                Span cmd = span_make(line, len);
 
-                // Check for rainbow command (case-insensitive compare)
-                if (string_case_compare(line, "#FULLRAINBOW") == 0) {
-                        for (uint16_t i = 0; i < 256; i++) {
-                                wheel((uint8_t)i);
-                                _delay_ms(20);
-                        }
-                        continue;
-                }
+                // Named commands first (case-insensitive), anything else must be a colour
+                if (command_dispatch(&cli, cmd, &separators) != COMMAND_UNKNOWN) continue;
+                cmd = span_trim(cmd);
 
                 // Validate LED color command: expecting "#RRGGBBDX" (9 characters)
-                if (strlen(line) == 9 && line[0] == '#' && line[7] == 'D' && (line[8] == '6' || line[8] == '7' || line[8] == '8')) {
-
-                        char    buf[3] = {0};
-                        int16_t r, g, b;
-
-                        buf[0]         = line[1];
-                        buf[1]         = line[2];
-                        r              = parse_number(buf, 16);
-
-                        buf[0]         = line[3];
-                        buf[1]         = line[4];
-                        g              = parse_number(buf, 16);
-
-                        buf[0]         = line[5];
-                        buf[1]         = line[6];
-                        b              = parse_number(buf, 16);
-
-                        Color newColor = {.r = (uint8_t)r, .g = (uint8_t)g, .b = (uint8_t)b};
+                Color newColor;
+                if (cmd.len == 9 && cmd.p[0] == '#' && cmd.p[7] == 'D' && (cmd.p[8] == '6' || cmd.p[8] == '7' || cmd.p[8] == '8') &&
+                    parse_channel(cmd, 1, &newColor.r) && parse_channel(cmd, 3, &newColor.g) && parse_channel(cmd, 5, &newColor.b)) {
 
-                        if (line[8] == '6') {
+                        if (cmd.p[8] == '6') {
                                 ledD6 = newColor;
-                        } else if (line[8] == '7') {
+                        } else if (cmd.p[8] == '7') {
                                 ledD7 = newColor;
-                        } else if (line[8] == '8') {
+                        } else if (cmd.p[8] == '8') {
                                 ledD8 = newColor;
                         }
 
                         spi_set_color(ledD6, ledD7, ledD8);
 
-                        uart_printf("New LED Colors: D6=#%02X%02X%02X, D7=#%02X%02X%02X, D8=#%02X%02X%02X\r\n",
-                                    ledD6.r,
-                                    ledD6.g,
-                                    ledD6.b,
-                                    ledD7.r,
-                                    ledD7.g,
-                                    ledD7.b,
-                                    ledD8.r,
-                                    ledD8.g,
-                                    ledD8.b);
+                        char          report[64];
+                        StringBuilder sb;
+                        string_builder_init(&sb, report, sizeof(report));
+                        string_builder_append_F(&sb, "New LED Colors: D6=");
+                        append_color(&sb, ledD6);
+                        string_builder_append_F(&sb, ", D7=");
+                        append_color(&sb, ledD7);
+                        string_builder_append_F(&sb, ", D8=");
+                        append_color(&sb, ledD8);
+                        string_builder_append_F(&sb, "\r\n");
+                        string_builder_send(&sb);
                 } else {
-                        uart_putline("Error: Invalid input. Expected format: #RRGGBBDX or #FULLRAINBOW");
+                        uart_putline_F("Error: Invalid input. Expected format: #RRGGBBDX or #FULLRAINBOW");
                 }
         }
         return 0;
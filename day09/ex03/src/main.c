@@ -1,6 +1,6 @@
 #include "libc.h"
+#include "clock.h"
 #include <avr/io.h>
-#include <util/delay.h>
 
 
 #define DIGIT_0 63  // 0x3F: segments a, b, c, d, e, f
@@ -76,27 +76,19 @@ int main(void) {
         pca9555_write(CONFIG_PORT1, 0xFF);
         pca9555_write(CONFIG_PORT1, 0x00);
 
+        static const uint8_t digits[] = {DIGIT_0, DIGIT_1, DIGIT_2, DIGIT_3, DIGIT_4, DIGIT_5, DIGIT_6, DIGIT_7, DIGIT_8, DIGIT_9};
+
+        clock_init();
+        uint8_t  digit = 0;
+        uint32_t shown = millis();
+        pca9555_write(OUTPUT_PORT1, digits[digit]);
+
         while (1) {
-                pca9555_write(OUTPUT_PORT1, DIGIT_0);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_1);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_2);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_3);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_4);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_5);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_6);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_7);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_8);
-                _delay_ms(1000);
-                pca9555_write(OUTPUT_PORT1, DIGIT_9);
-                _delay_ms(1000);
+                // one step per second against the clock, the loop stays free in between
+                if (!elapsed(shown, 1000)) continue;
+                shown += 1000;
+                digit = (digit + 1) % sizeof(digits);
+                pca9555_write(OUTPUT_PORT1, digits[digit]);
         }
 
         return 0;
@@ -1,6 +1,6 @@
 #include "libc.h"
+#include "scheduler.h"
 #include <avr/io.h>
-#include <util/delay.h>
 
 #define PCA9555_ADDR 0x20
 #define CONFIG_PORT0 0x06 // Digit selection configuration
@@ -75,74 +75,51 @@ uint16_t read_adc(void) {
         return ADC;
 }
 
+// Segments of each digit, d[0] = ones. Written by the sampling task, read by the display task.
+uint8_t  segments[4] = {DIGIT_0, DIGIT_0, DIGIT_0, DIGIT_0};
+uint16_t counter     = 0;
+
+void show_counter(void) {
+        // Digits above the highest significant one show 0, as before.
+        uint16_t temp = counter;
+        for (uint8_t i = 0; i < 4; i++) {
+                segments[i] = digitCodes[temp % 10];
+                temp /= 10;
+        }
+}
+
+// Priority 0, every 4 ms: light the next digit. Each digit stays on until the
+// next run, so the refresh rate no longer depends on the rest of the work.
+// The three blocking I2C writes take about 0.9 ms at 100 kHz, a 4 ms period
+// still refreshes the four digits at 62 Hz and leaves the CPU to sample_adc.
+void refresh_display(void *ctx) {
+        static uint8_t current = 0;
+        (void)ctx;
+        pca9555_write(OUTPUT_PORT0, 0xFF); // Deselect all digits.
+        pca9555_write(OUTPUT_PORT1, segments[current]);
+        pca9555_write(OUTPUT_PORT0, digitSelect[current]);
+        current = (current + 1) & 3;
+}
+
+// Priority 1, every 20 ms: sample RV1 and follow it with a 1 LSB hysteresis.
+void sample_adc(void *ctx) {
+        (void)ctx;
+        const uint16_t now = read_adc();
+        if ((now > counter ? now - counter : counter - now) <= 1) return;
+        counter = now;
+        show_counter();
+}
+
 int main(void) {
         adc_init();
         TWI_init();
 
-        // Configure both ports as outputs initially.
-        pca9555_write(0x06, 0x00); // Port0: digit selection as outputs
-
-        pca9555_write(0x07, 0x00); // Port1: segments as outputs
-
-        uint16_t counter = 0;
-
-        while (1) {
-                // Determine active digits based on counter value.
-                uint8_t activeDigits;
-                if (counter < 10)
-                        activeDigits = 1;
-                else if (counter < 100)
-                        activeDigits = 2;
-                else if (counter < 1000)
-                        activeDigits = 3;
-                else
-                        activeDigits = 4;
-
-                // Extract individual digits.
-                // d[0] = ones, d[1] = tens, etc.
-                uint8_t  d[4] = {BLANK_DIGIT, BLANK_DIGIT, BLANK_DIGIT, BLANK_DIGIT};
-                uint16_t temp = counter;
-                for (uint8_t i = 0; i < activeDigits; i++) {
-                        d[i] = temp % 10;
-                        temp /= 10;
-                }
-
-                // // Refresh display for 1 second. Within this time, each digit is multiplexed rapidly.
-                // // Adjust the inner loop count and delay for stable, flicker-free display.
-                // for (uint8_t refresh = 0; refresh < 100; refresh++) { // 50 cycles * (4 * ~5ms) ≈ 1 second
-                // }
-                for (uint8_t i = 0; i < 4; i++) {
-                        // Activate the digit by selecting it.
-                        pca9555_write(OUTPUT_PORT0, digitSelect[i]);
-                        // Make sure the segments are in output mode.
-                        pca9555_write(CONFIG_PORT1, 0x00);
-                        // Only display a digit if it is active; otherwise blank.
-                        if (i < activeDigits)
-                                pca9555_write(OUTPUT_PORT1, digitCodes[d[i]]);
-                        else
-                                pca9555_write(OUTPUT_PORT1, DIGIT_0);
-
-                        _delay_ms(1); // Active period for the digit.
-
-                        pca9555_write(OUTPUT_PORT0, 0xFF); // Deselect all digits.
-                        pca9555_write(OUTPUT_PORT1, BLANK_DIGIT);
-                }
-
-
-                const uint16_t now = read_adc();
-                if (now > counter) {
-                        if (now - counter <= 1) {
-                                continue;
-                        } else {
-                                counter = now;
-                        }
-                } else if (counter > now) {
-                        if (counter - now <= 1) {
-                                continue;
-                        } else {
-                                counter = now;
-                        }
-                }
-        }
-        return 0;
+        // Configure both ports as outputs.
+        pca9555_write(CONFIG_PORT0, 0x00); // Port0: digit selection as outputs
+        pca9555_write(CONFIG_PORT1, 0x00); // Port1: segments as outputs
+
+        clock_init();
+        scheduler_add(0, refresh_display, NULL, 4, 2);
+        scheduler_add(1, sample_adc, NULL, 20, 0);
+        scheduler_run();
 }
@@ -0,0 +1,141 @@
+#include "libc.h"
+#include <util/atomic.h>
+
+/*
+ * Timer1 runs at clk/1 with interrupts held off, so a count is CPU cycles.
+ * The longest conversion stays well below the 65536 cycle wrap.
+ */
+static volatile uint16_t sink_bytes;
+
+static void sink_put(void *ctx, char c) {
+        (void)ctx;
+        (void)c;
+        sink_bytes++;
+}
+
+/* The converter uart_printf used before the per-base converters, same sink */
+__attribute__((noinline)) static int16_t old_fmt_number(uint32_t number, uint8_t base, int pad_width, char pad_char) {
+        int16_t printed = 0;
+        char    buf[33];
+        int     pos = 0;
+
+        if (number == 0) {
+                buf[pos++] = '0';
+        } else {
+                while (number) {
+                        uint8_t digit = number % base;
+                        number /= base;
+                        buf[pos++] = (digit < 10) ? ('0' + digit) : ('A' + digit - 10);
+                }
+        }
+        int pad_count = pad_width - pos;
+        while (pad_count-- > 0) {
+                sink_put(NULL, pad_char);
+                printed++;
+        }
+        for (int i = pos - 1; i >= 0; i--) {
+                sink_put(NULL, buf[i]);
+                printed++;
+        }
+        return printed;
+}
+
+/*
+ * The classifiers the flag table replaced, out of line as they were in libc.c.
+ * The chain is kept verbatim, only renamed so it does not clash with libc.h.
+ */
+__attribute__((noinline)) static bool old_is_whitespace(uint8_t c) {
+        return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\v') || (c == '\f');
+}
+
+__attribute__((noinline)) static bool old_is_alphabetic(uint8_t c) {
+        return ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z'));
+}
+
+__attribute__((noinline)) static bool old_is_digit(uint8_t c) {
+        return (c >= '0' && c <= '9');
+}
+
+__attribute__((noinline)) static bool old_is_alphanumeric(uint8_t c) {
+        return old_is_alphabetic(c) || old_is_digit(c);
+}
+
+__attribute__((noinline)) static bool old_is_xdigit(uint8_t c) {
+        return old_is_digit(c) || ((c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'));
+}
+
+__attribute__((noinline)) static bool old_is_punctuation(uint8_t c) {
+        if (c < 32 || c > 126) return false;
+        if (old_is_alphanumeric(c) || old_is_whitespace(c)) return false;
+        return true;
+}
+
+static volatile uint16_t class_hits;
+
+/* Classifies every byte value once, the loop costs the same in both columns */
+#define CLASSIFY_ALL(is)                                                                                                                                       \
+        do {                                                                                                                                                   \
+                uint16_t hits_ = 0;                                                                                                                            \
+                uint8_t  c_    = 0;                                                                                                                            \
+                do {                                                                                                                                           \
+                        hits_ += is(c_);                                                                                                                       \
+                } while (++c_);                                                                                                                                \
+                class_hits = hits_;                                                                                                                            \
+        } while (0)
+
+#define BENCH(out, call)                                                                                                                                       \
+        do {                                                                                                                                                   \
+                ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {                                                                                                            \
+                        uint16_t start_ = TCNT1;                                                                                                               \
+                        call;                                                                                                                                  \
+                        (out) = TCNT1 - start_;                                                                                                                \
+                }                                                                                                                                              \
+        } while (0)
+
+static const uint32_t bench_values[] PROGMEM = {0, 9, 255, 9999, 65535, 123456, 4294967295UL};
+
+int main(void) {
+        UartOption opts = {.baud_rate = 115200, .transmit = true, .receive = false};
+        uart_init(&opts);
+
+        TCCR1A = 0;
+        TCCR1B = _BV(CS10);
+
+        /* "%c" costs the call, the format parsing and one byte: the floor of every fmt_sink row */
+        uint16_t floor;
+        BENCH(floor, fmt_sink(sink_put, NULL, "%c", '0'));
+        uart_printf_F("fmt_sink %%c floor: %u cycles\r\n", floor);
+        uart_printf_F("%10S %6S %6S %6S %6S\r\n", PSTR("value"), PSTR("old10"), PSTR("new10"), PSTR("old16"), PSTR("new16"));
+
+        for (uint8_t i = 0; i < sizeof(bench_values) / sizeof(bench_values[0]); i++) {
+                uint32_t v = pgm_read_dword(&bench_values[i]);
+                uint16_t old10, new10, old16, new16;
+
+                BENCH(old10, old_fmt_number(v, 10, 0, ' '));
+                BENCH(new10, fmt_sink(sink_put, NULL, "%lu", v));
+                BENCH(old16, old_fmt_number(v, 16, 0, ' '));
+                BENCH(new16, fmt_sink(sink_put, NULL, "%lX", v));
+                uart_printf_F("%10lu %6u %6u %6u %6u\r\n", v, old10, new10, old16, new16);
+                uart_flush();
+        }
+
+        /* 256 calls per row, the hit counts must match between the columns */
+        uart_printf_F("\r\n%14S %6S %6S %5S\r\n", PSTR("class x256"), PSTR("old"), PSTR("table"), PSTR("hits"));
+        uint16_t old_cycles, new_cycles, old_hits;
+
+        BENCH(old_cycles, CLASSIFY_ALL(old_is_whitespace));
+        old_hits = class_hits;
+        BENCH(new_cycles, CLASSIFY_ALL(is_whitespace));
+        uart_printf_F("%14S %6u %6u %2u/%u\r\n", PSTR("is_whitespace"), old_cycles, new_cycles, old_hits, class_hits);
+        BENCH(old_cycles, CLASSIFY_ALL(old_is_punctuation));
+        old_hits = class_hits;
+        BENCH(new_cycles, CLASSIFY_ALL(is_punctuation));
+        uart_printf_F("%14S %6u %6u %2u/%u\r\n", PSTR("is_punctuation"), old_cycles, new_cycles, old_hits, class_hits);
+        BENCH(old_cycles, CLASSIFY_ALL(old_is_xdigit));
+        old_hits = class_hits;
+        BENCH(new_cycles, CLASSIFY_ALL(is_xdigit));
+        uart_printf_F("%14S %6u %6u %2u/%u\r\n", PSTR("is_xdigit"), old_cycles, new_cycles, old_hits, class_hits);
+        uart_flush();
+        loop {
+        }
+}
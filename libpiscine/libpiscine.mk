@@ -0,0 +1,37 @@
+# **************************************************************************** #
+#                                                                              #
+#    libpiscine: shared libc and drivers, built in each firmware build dir     #
+#    so that per-firmware -D options (queue sizes, ...) still apply to it.     #
+#    Every function gets its own section and the link runs with LTO and       #
+#    --gc-sections, so a firmware only carries the parts it calls.            #
+#                                                                              #
+#    include ../../libpiscine/libpiscine.mk   (after the build targets)        #
+#                                                                              #
+# **************************************************************************** #
+
+PISCINE_DIR := $(patsubst %/,%,$(dir $(lastword $(MAKEFILE_LIST))))
+PISCINE_SRC := $(wildcard $(PISCINE_DIR)/src/*.c)
+PISCINE_OBJ := $(patsubst $(PISCINE_DIR)/src/%.c,$(BUILD_DIR)/piscine/%.o,$(PISCINE_SRC))
+PISCINE_LIB := $(BUILD_DIR)/libpiscine.a
+# gcc-ar keeps the LTO symbol index that plain ar cannot read
+AR          := avr-gcc-ar
+
+CFLAGS      += -I$(PISCINE_DIR)/src -ffunction-sections -fdata-sections -flto
+LDFLAGS     += -Os -flto -Wl,--gc-sections
+
+$(TARGET).elf: $(PISCINE_LIB)
+$(PISCINE_LIB): $(PISCINE_OBJ)
+	@echo " [AR]   $@"
+	$(Q)rm -f $@
+	$(Q)$(AR) rcs $@ $^
+$(BUILD_DIR)/piscine/%.o: $(PISCINE_DIR)/src/%.c | $(BUILD_DIR)/piscine
+	@echo " [CC]   $<"
+	$(Q)$(CC) $(CFLAGS) -c $< -o $@
+$(BUILD_DIR)/piscine:
+	@echo " [MKDIR] $@"
+	$(Q)mkdir -p $@
+clean: clean-piscine
+clean-piscine:
+	$(Q)rm -f $(PISCINE_LIB) $(PISCINE_OBJ) $(PISCINE_OBJ:.o=.d)
+.PHONY: clean-piscine
+-include $(PISCINE_OBJ:.o=.d)
@@ -0,0 +1,47 @@
+#include "clock.h"
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+static volatile uint32_t clock_ms;
+
+ISR(TIMER1_COMPA_vect) {
+        clock_ms++;
+}
+
+void clock_init(void) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                TCCR1A   = 0;
+                TCCR1B   = (1 << WGM12) | (1 << CS10); // CTC on OCR1A, clk/1
+                OCR1A    = CLOCK_CYCLES_PER_MS - 1;
+                TCNT1    = 0;
+                TIFR1    = (1 << OCF1A);
+                TIMSK1  |= (1 << OCIE1A);
+                clock_ms = 0;
+        }
+        sei();
+}
+
+/* 32-bit reads take four loads, the ISR must not land between them */
+uint32_t millis(void) {
+        uint32_t ms;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                ms = clock_ms;
+        }
+        return ms;
+}
+
+uint32_t micros(void) {
+        uint32_t ms;
+        uint16_t count;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                ms    = clock_ms;
+                count = TCNT1;
+                /*
+                 * A compare that happened inside this block has not been
+                 * counted yet. A low count means it came before the read.
+                 */
+                if ((TIFR1 & (1 << OCF1A)) && count < CLOCK_CYCLES_PER_MS / 2) ms++;
+        }
+        return ms * 1000 + count / (F_CPU / 1000000UL);
+}
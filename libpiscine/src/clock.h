@@ -0,0 +1,41 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+/*
+ * System clock on Timer1, which clock_init() takes over: CTC mode without a
+ * prescaler and a compare every F_CPU / 1000 cycles, so millis() advances
+ * exactly once per millisecond and micros() adds the running counter read
+ * at cycle resolution. millis() wraps after ~49 days and micros() after ~71
+ * minutes; always compare times by subtraction, as elapsed() does.
+ * uart_autobaud() borrows Timer1 and restores it, but the clock stands still
+ * for as long as it waits for the byte.
+ *
+ *   uint32_t last = millis();
+ *   loop {
+ *           if (elapsed(last, 20)) { last += 20; sample(); }
+ *           ...other work...
+ *   }
+ */
+#define CLOCK_CYCLES_PER_MS (F_CPU / 1000UL)
+
+#if CLOCK_CYCLES_PER_MS > 65536UL || F_CPU % 1000000UL
+#error "the system clock needs a whole MHz F_CPU of at most 65 MHz"
+#endif
+
+void     clock_init(void);
+uint32_t millis(void);
+uint32_t micros(void);
+
+/* True once period milliseconds have passed since the millis() value since */
+static inline bool elapsed(uint32_t since, uint32_t period) {
+        return millis() - since >= period;
+}
+
+#endif // CLOCK_H
@@ -0,0 +1,2003 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   libc.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: pollivie <pollivie.student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/13 22:05:30 by pollivie          #+#    #+#             */
+/*   Updated: 2025/03/13 22:05:30 by pollivie         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "libc.h"
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include <util/crc16.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+#if UART_TX_BUFFER_SIZE < 2 || UART_TX_BUFFER_SIZE > 256 || (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1))
+#error "UART_TX_BUFFER_SIZE must be a power of two between 2 and 256"
+#endif
+
+#if UART_RX_BUFFER_SIZE < 2 || UART_RX_BUFFER_SIZE > 256 || (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1))
+#error "UART_RX_BUFFER_SIZE must be a power of two between 2 and 256"
+#endif
+
+#if UART_LINE_QUEUE_DEPTH == 1 || UART_LINE_QUEUE_DEPTH > 255
+#error "UART_LINE_QUEUE_DEPTH must be 0 or between 2 and 255"
+#endif
+
+#if UART_LINE_QUEUE_DEPTH > 0 && (UART_LINE_SIZE < 2 || UART_LINE_SIZE > 256)
+#error "UART_LINE_SIZE must be between 2 and 256"
+#endif
+
+#define UART_TX_MASK (UART_TX_BUFFER_SIZE - 1)
+#define UART_RX_MASK (UART_RX_BUFFER_SIZE - 1)
+
+static uint8_t           uart_initialized = false;
+
+static uint8_t           uart_tx_buffer[UART_TX_BUFFER_SIZE];
+static volatile uint8_t  uart_tx_head    = 0; // next free slot, only written by producers
+static volatile uint8_t  uart_tx_tail    = 0; // next byte to send, only written by the consumer
+static volatile uint16_t uart_tx_drops   = 0;
+static volatile bool     uart_tx_started = false;
+static UartTxPolicy      uart_tx_policy  = UART_TX_BLOCK;
+
+static uint8_t           uart_rx_buffer[UART_RX_BUFFER_SIZE];
+static volatile uint8_t  uart_rx_head    = 0; // only written by USART_RX_vect
+static volatile uint8_t  uart_rx_tail    = 0; // only written by the reader
+static UartRxStats       uart_rx_errors; // written by USART_RX_vect, read atomically
+
+void                     uart_configure(const UartOption *opts, uint16_t baud_setting) {
+        if (uart_initialized) return;
+        uart_initialized = true;
+
+        UBRR0H = (baud_setting & UART_BAUD_UBRR_MASK) >> 8;
+        UBRR0L = baud_setting;
+        UCSR0A = (baud_setting & UART_BAUD_U2X) ? (1 << U2X0) : 0;
+
+        if (!opts) {
+                UCSR0B = (1 << TXEN0) | (1 << RXEN0) | (1 << RXCIE0);
+                UCSR0C = (1 << UCSZ01) | (1 << UCSZ00);
+        } else {
+                if (opts->receive) {
+                        UCSR0B |= (1 << RXEN0) | (1 << RXCIE0);
+                }
+                if (opts->transmit) {
+                        UCSR0B |= (1 << TXEN0);
+                }
+                UCSR0C         = (1 << UCSZ01) | (1 << UCSZ00);
+                uart_tx_policy = opts->tx_policy;
+        }
+        sei();
+}
+
+uint16_t uart_baud_lookup(uint32_t baud) {
+        if (!baud) baud = UART_DEFAULT_BAUD;
+        return uart_baud_setting(baud);
+}
+
+static const uint32_t uart_standard_bauds[] PROGMEM = {
+    2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 76800, 115200, 230400, 250000, 500000, 1000000, 2000000,
+};
+
+/*
+ * Times the first incoming byte, which must be 'U' (0x55): its falling
+ * edges, start bit included, are two bit times apart, so the start edge to
+ * the fifth one spans 8 bits and the ~3 cycle poll of PD0 is spread over
+ * all of them. Returns the closest standard baud rate, or the raw
+ * measurement if none is within ~6%; uart_init() returns false when no
+ * UBRR setting reaches it. Blocks with interrupts disabled until a byte
+ * arrives, call it before uart_init(). At 16 MHz it is good from 2400
+ * baud, where 8 bits still fit the 16-bit timer, to about 1M; at 2M the
+ * poll jitter alone is ~6% of the span.
+ *
+ * ICP1 sits on PB0 rather than RXD, so Timer1 is used as a free running
+ * timestamp while PD0 is polled. The Timer1 setup is put back afterwards,
+ * so clock_init() may run before, but the system clock does not advance
+ * while we wait for the byte.
+ */
+uint32_t uart_autobaud(void) {
+        uint16_t span;
+
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                uint8_t  saved_a     = TCCR1A;
+                uint8_t  saved_b     = TCCR1B;
+                uint8_t  saved_mask  = TIMSK1;
+                uint8_t  saved_flags = TIFR1;
+                uint16_t saved_ocr   = OCR1A;
+                uint16_t saved_count = TCNT1;
+
+                TCCR1B = 0;
+                TIMSK1 = 0;
+                TCCR1A = 0;
+                TCCR1B = (1 << CS10);
+                while (!(PIND & (1 << PD0)))
+                        ;
+                while (PIND & (1 << PD0))
+                        ;
+                uint16_t start = TCNT1;
+                for (uint8_t edge = 0; edge < 4; edge++) {
+                        while (!(PIND & (1 << PD0)))
+                                ;
+                        while (PIND & (1 << PD0))
+                                ;
+                }
+                span = TCNT1 - start;
+
+                /* bit 7 is low, wait for the stop bit so it is not mistaken for a start bit */
+                while (!(PIND & (1 << PD0)))
+                        ;
+                /* drop the flags the free running count raised, keep those already pending */
+                TCCR1B = 0;
+                TIFR1  = ~saved_flags & ((1 << ICF1) | (1 << OCF1B) | (1 << OCF1A) | (1 << TOV1));
+                OCR1A  = saved_ocr;
+                TCNT1  = saved_count;
+                TIMSK1 = saved_mask;
+                TCCR1A = saved_a;
+                TCCR1B = saved_b;
+        }
+        if (span < 8) return UART_DEFAULT_BAUD;
+
+        uint32_t measured = (F_CPU * 8) / span;
+        uint32_t best     = measured;
+        uint16_t best_err = 256 / 16;
+        for (uint8_t i = 0; i < sizeof(uart_standard_bauds) / sizeof(uart_standard_bauds[0]); i++) {
+                uint32_t rate  = pgm_read_dword(&uart_standard_bauds[i]);
+                uint32_t delta = measured > rate ? measured - rate : rate - measured;
+                if (delta >= rate) continue;
+                uint16_t err = (delta << 8) / rate;
+                if (err < best_err) {
+                        best_err = err;
+                        best     = rate;
+                }
+        }
+        return best;
+}
+
+/* Moves one queued byte into UDR0, caller guarantees the queue is not empty */
+static inline void uart_tx_send_next(void) {
+        uint8_t tail = uart_tx_tail;
+        UCSR0A       = (UCSR0A & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
+        UDR0         = uart_tx_buffer[tail];
+        uart_tx_tail    = (tail + 1) & UART_TX_MASK;
+        uart_tx_started = true;
+}
+
+ISR(USART_UDRE_vect) {
+        if (uart_tx_head != uart_tx_tail) {
+                uart_tx_send_next();
+        }
+        if (uart_tx_head == uart_tx_tail) {
+                UCSR0B &= ~(1 << UDRIE0);
+        }
+}
+
+/*
+ * Queues one byte for USART_UDRE_vect. The slot is claimed with interrupts off
+ * so main code and ISRs may both print. When the queue is full the byte is
+ * either dropped or we wait for room, draining by hand if we were called with
+ * interrupts disabled (from an ISR or before sei()) so we never deadlock.
+ */
+static inline bool uart_tx_try_enqueue(uint8_t c) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                uint8_t head = uart_tx_head;
+                uint8_t next = (head + 1) & UART_TX_MASK;
+                if (next != uart_tx_tail) {
+                        uart_tx_buffer[head] = c;
+                        uart_tx_head         = next;
+                        UCSR0B |= (1 << UDRIE0);
+                        return true;
+                }
+        }
+        return false;
+}
+
+static bool uart_tx_enqueue(uint8_t c) {
+        loop {
+                if (uart_tx_try_enqueue(c)) return true;
+                if (uart_tx_policy == UART_TX_DROP) {
+                        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                                uart_tx_drops++;
+                        }
+                        return false;
+                }
+                if (!(SREG & (1 << SREG_I))) {
+                        loop_until_bit_is_set(UCSR0A, UDRE0);
+                        uart_tx_send_next();
+                }
+        }
+}
+
+void uart_flush(void) {
+        if (!uart_initialized) return;
+        while (uart_tx_head != uart_tx_tail) {
+                if (!(SREG & (1 << SREG_I))) {
+                        loop_until_bit_is_set(UCSR0A, UDRE0);
+                        uart_tx_send_next();
+                }
+        }
+        /* TXC0 is cleared on every load of UDR0, so once set the last stop bit is out */
+        if (uart_tx_started) {
+                loop_until_bit_is_set(UCSR0A, TXC0);
+        }
+}
+
+uint8_t uart_tx_pending(void) {
+        return (uart_tx_head - uart_tx_tail) & UART_TX_MASK;
+}
+
+uint16_t uart_tx_dropped(void) {
+        uint16_t drops;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                drops = uart_tx_drops;
+        }
+        return drops;
+}
+
+static inline void uart_rx_count(uint16_t *counter) {
+        if (*counter != 0xFFFF) (*counter)++;
+}
+
+#if UART_LINE_QUEUE_DEPTH > 0
+
+/*
+ * Line assembly in interrupt context: USART_RX_vect edits the line in the
+ * head slot and publishes it on CR or LF, the reader only ever copies out
+ * finished lines. The head slot is always being assembled, so at most
+ * UART_LINE_QUEUE_DEPTH - 1 lines wait to be taken.
+ */
+static char             uart_line_slots[UART_LINE_QUEUE_DEPTH][UART_LINE_SIZE];
+static uint8_t          uart_line_lens[UART_LINE_QUEUE_DEPTH];
+static volatile uint8_t uart_line_head    = 0; // slot being assembled, only written by USART_RX_vect
+static volatile uint8_t uart_line_tail    = 0; // oldest finished line, only written by the reader
+static uint8_t          uart_line_fill    = 0;
+static volatile bool    uart_line_enabled = false;
+static bool             uart_line_echo    = false;
+static bool             uart_line_skip_lf = false;
+
+static inline uint8_t   uart_line_next(uint8_t slot) {
+        return (slot + 1 == UART_LINE_QUEUE_DEPTH) ? 0 : slot + 1;
+}
+
+/* Echo never waits in interrupt context, a full transmit queue counts as a drop */
+static void uart_line_put(const char *str) {
+        if (!uart_line_echo) return;
+        while (*str) {
+                if (!uart_tx_try_enqueue(*str++)) uart_tx_drops++;
+        }
+}
+
+static inline void uart_line_receive(uint8_t c) {
+        bool skip_lf      = uart_line_skip_lf;
+        uart_line_skip_lf = false;
+
+        if (c == '\r' || c == '\n') {
+                if (c == '\n' && skip_lf) return;
+                uart_line_skip_lf = (c == '\r');
+                uart_line_put("\r\n");
+
+                uint8_t head = uart_line_head;
+                uint8_t next = uart_line_next(head);
+                if (next == uart_line_tail) {
+                        uart_rx_count(&uart_rx_errors.overflows);
+                } else {
+                        uart_line_slots[head][uart_line_fill] = '\0';
+                        uart_line_lens[head]                  = uart_line_fill;
+                        uart_line_head                        = next;
+                }
+                uart_line_fill = 0;
+                return;
+        }
+        if (c == '\b' || c == 0x7F) {
+                if (uart_line_fill) {
+                        uart_line_fill--;
+                        uart_line_put("\b \b");
+                }
+                return;
+        }
+        if (c < ' ' || c > '~' || uart_line_fill >= UART_LINE_SIZE - 1) return;
+
+        uart_line_slots[uart_line_head][uart_line_fill++] = c;
+        char echo[2]                                      = {c, '\0'};
+        uart_line_put(echo);
+}
+
+#endif
+
+/* Moves the byte waiting in UDR0 into the receive queue, status must be read first */
+static inline void uart_rx_receive(void) {
+        uint8_t status = UCSR0A;
+        uint8_t c      = UDR0;
+
+        if (status & (1 << DOR0)) {
+                uart_rx_count(&uart_rx_errors.overruns);
+        }
+        if (status & (1 << FE0)) {
+                uart_rx_count(&uart_rx_errors.frame_errors);
+                return;
+        }
+#if UART_LINE_QUEUE_DEPTH > 0
+        if (uart_line_enabled) {
+                uart_line_receive(c);
+                return;
+        }
+#endif
+        uint8_t head = uart_rx_head;
+        uint8_t next = (head + 1) & UART_RX_MASK;
+        if (next == uart_rx_tail) {
+                uart_rx_count(&uart_rx_errors.overflows);
+                return;
+        }
+        uart_rx_buffer[head] = c;
+        uart_rx_head         = next;
+}
+
+ISR(USART_RX_vect) {
+        uart_rx_receive();
+}
+
+/* With interrupts disabled USART_RX_vect cannot run, so pull the byte in ourselves */
+static inline void uart_rx_poll(void) {
+        if (!(SREG & (1 << SREG_I)) && (UCSR0A & (1 << RXC0))) {
+                uart_rx_receive();
+        }
+}
+
+uint8_t uart_available(void) {
+        uart_rx_poll();
+        return (uart_rx_head - uart_rx_tail) & UART_RX_MASK;
+}
+
+int16_t uart_try_getchar(void) {
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        uart_rx_poll();
+        uint8_t tail = uart_rx_tail;
+        if (tail == uart_rx_head) return -1;
+        uint8_t c    = uart_rx_buffer[tail];
+        uart_rx_tail = (tail + 1) & UART_RX_MASK;
+        return c;
+}
+
+#if UART_LINE_QUEUE_DEPTH > 0
+
+void uart_line_mode(bool enable, bool echo) {
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                uart_line_enabled = enable;
+                uart_line_echo    = echo;
+                uart_line_fill    = 0;
+                uart_line_skip_lf = false;
+        }
+}
+
+bool uart_line_ready(void) {
+        uart_rx_poll();
+        return uart_line_tail != uart_line_head;
+}
+
+int16_t uart_take_line(char *buff, size_t bufsize) {
+        if (!buff || !bufsize) return -1;
+        uart_rx_poll();
+        uint8_t tail = uart_line_tail;
+        if (tail == uart_line_head) return -1;
+
+        uint8_t len = uart_line_lens[tail];
+        if (len > bufsize - 1) len = bufsize - 1;
+        for (uint8_t i = 0; i < len; i++) {
+                buff[i] = uart_line_slots[tail][i];
+        }
+        buff[len]      = '\0';
+        uart_line_tail = uart_line_next(tail);
+        return len;
+}
+
+#endif
+
+void uart_rx_stats(UartRxStats *stats) {
+        if (!stats) return;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                *stats = uart_rx_errors;
+        }
+}
+
+void uart_rx_stats_reset(void) {
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                uart_rx_errors = (UartRxStats){0};
+        }
+}
+
+/* Where the formatter sends its bytes, and how many it sent */
+typedef struct {
+        FmtPut  put;
+        void   *ctx;
+        int16_t count;
+} FmtOut;
+
+static inline void fmt_emit(FmtOut *out, char c) {
+        out->put(out->ctx, c);
+        out->count++;
+}
+
+/* Conversion flags collected between '%' and the conversion character */
+typedef struct {
+        uint8_t width;
+        char    pad;   // '0' or ' '
+        bool    left;  // '-': pad on the right
+        bool    upper;    // upper case hex digits
+        uint8_t decimals; // ".n" on d/i/u: the integer is scaled by 10^n
+} FmtSpec;
+
+/* Enough for 32 binary digits */
+#define FMT_DIGITS_MAX   32
+
+/* A uint32_t has 10 decimal digits, so more places would only add zeros */
+#define FMT_DECIMALS_MAX 9
+
+static const char fmt_digit_pairs[200] PROGMEM = "00010203040506070809"
+                                                 "10111213141516171819"
+                                                 "20212223242526272829"
+                                                 "30313233343536373839"
+                                                 "40414243444546474849"
+                                                 "50515253545556575859"
+                                                 "60616263646566676869"
+                                                 "70717273747576777879"
+                                                 "80818283848586878889"
+                                                 "90919293949596979899";
+
+/* n / 10 by shifts and adds, avoids __udivmodsi4 (Hacker's Delight 10-9) */
+static inline uint32_t fmt_div10_u32(uint32_t n) {
+        uint32_t q = (n >> 1) + (n >> 2);
+        q += q >> 4;
+        q += q >> 8;
+        q += q >> 16;
+        q >>= 3;
+        uint32_t r = n - ((q << 3) + (q << 1));
+        return q + (r > 9);
+}
+
+/* Exact n / 100 for every 16-bit n, one 16x16 multiply */
+static inline uint16_t fmt_div100_u16(uint16_t n) {
+        return ((uint32_t)(n >> 2) * 0x147B) >> 17;
+}
+
+/*
+ * The converters below write digits backwards ending at `end` and return how
+ * many were written. Only the top of a 32-bit value goes through the 32-bit
+ * path, everything below 65536 is emitted two digits per step from a table.
+ */
+static uint8_t fmt_dec(char *end, uint32_t n) {
+        char *p = end;
+
+        while (n > 0xFFFF) {
+                uint32_t q = fmt_div10_u32(n);
+                *--p       = '0' + (uint8_t)(n - ((q << 3) + (q << 1)));
+                n          = q;
+        }
+        uint16_t m = n;
+        while (m >= 100) {
+                uint16_t q = fmt_div100_u16(m);
+                uint8_t  r = m - q * 100;
+                p -= 2;
+                p[0] = pgm_read_byte(&fmt_digit_pairs[r * 2]);
+                p[1] = pgm_read_byte(&fmt_digit_pairs[r * 2 + 1]);
+                m    = q;
+        }
+        if (m >= 10) {
+                p -= 2;
+                p[0] = pgm_read_byte(&fmt_digit_pairs[m * 2]);
+                p[1] = pgm_read_byte(&fmt_digit_pairs[m * 2 + 1]);
+        } else {
+                *--p = '0' + m;
+        }
+        return end - p;
+}
+
+static uint8_t fmt_hex(char *end, uint32_t n, bool upper) {
+        char   *p      = end;
+        uint8_t letter = (upper ? 'A' : 'a') - 10;
+
+        do {
+                uint8_t byte = n;
+                uint8_t lo   = byte & 0x0F;
+                uint8_t hi   = byte >> 4;
+                *--p         = lo < 10 ? '0' + lo : letter + lo;
+                *--p         = hi < 10 ? '0' + hi : letter + hi;
+                n >>= 8;
+        } while (n);
+        if (*p == '0' && p + 1 < end) p++;
+        return end - p;
+}
+
+static uint8_t fmt_bin(char *end, uint32_t n) {
+        char *p = end;
+
+        do {
+                uint8_t byte = n;
+                for (uint8_t bit = 0; bit < 8; bit++) {
+                        *--p = '0' + (byte & 1);
+                        byte >>= 1;
+                }
+                n >>= 8;
+        } while (n);
+        while (*p == '0' && p + 1 < end) p++;
+        return end - p;
+}
+
+static void fmt_pad(FmtOut *out, char c, int16_t count) {
+        while (count-- > 0) fmt_emit(out, c);
+}
+
+/* Emits len bytes from SRAM or flash, space padded to the field width */
+static void fmt_text(FmtOut *out, const char *s, uint16_t len, bool in_flash, const FmtSpec *spec) {
+        int16_t fill = (int16_t)spec->width - len;
+
+        if (!spec->left) fmt_pad(out, ' ', fill);
+        for (uint16_t i = 0; i < len; i++) {
+                fmt_emit(out, in_flash ? (char)pgm_read_byte(s + i) : s[i]);
+        }
+        if (spec->left) fmt_pad(out, ' ', fill);
+}
+
+/* Emits sign/prefix, padding and digits honouring width, '0' and '-' */
+static void fmt_integer(FmtOut *out, uint32_t value, bool negative, uint8_t base, const FmtSpec *spec, const char *prefix) {
+        char    buf[FMT_DIGITS_MAX];
+        char   *end = buf + sizeof(buf);
+        uint8_t len;
+
+        if (base == 10)
+                len = fmt_dec(end, value);
+        else if (base == 16)
+                len = fmt_hex(end, value, spec->upper);
+        else
+                len = fmt_bin(end, value);
+
+        if (spec->decimals && base == 10) {
+                /* fixed point: at least one integer digit, then the point before the last n digits */
+                uint8_t n = spec->decimals;
+                while (len <= n) *(end - ++len) = '0';
+                char *p = end - len;
+                for (uint8_t i = 0; i < len - n; i++) p[i - 1] = p[i];
+                *(end - n - 1) = '.';
+                len++;
+        }
+
+        if (negative) prefix = "-";
+        uint8_t prefix_len = prefix ? string_length(prefix) : 0;
+        int16_t fill       = (int16_t)spec->width - len - prefix_len;
+
+        if (!spec->left && spec->pad == ' ') fmt_pad(out, ' ', fill);
+        for (uint8_t i = 0; i < prefix_len; i++) fmt_emit(out, prefix[i]);
+        if (!spec->left && spec->pad == '0') fmt_pad(out, '0', fill);
+        for (char *p = end - len; p < end; p++) fmt_emit(out, *p);
+        if (spec->left) fmt_pad(out, ' ', fill);
+}
+
+/* Format strings live either in SRAM or, for the _P variants, in flash */
+static inline char fmt_peek(const char *fmt, bool in_flash) {
+        return in_flash ? (char)pgm_read_byte(fmt) : *fmt;
+}
+
+/*
+ * The formatting engine shared by every printf-like entry point. It knows
+ * nothing about the UART: each byte goes to out->put, so the same format can
+ * be rendered into a buffer, a queue or a device.
+ */
+static int16_t fmt_format(FmtOut *out, const char *fmt, va_list args, bool in_flash) {
+        char c;
+
+        while ((c = fmt_peek(fmt, in_flash))) {
+                if (c == '%') {
+                        c = fmt_peek(++fmt, in_flash);
+                        if (!c) break;
+
+                        FmtSpec spec = {.width = 0, .pad = ' ', .left = false, .upper = false, .decimals = 0};
+                        bool    wide = false;
+
+                        for (;; c = fmt_peek(++fmt, in_flash)) {
+                                if (c == '-')
+                                        spec.left = true;
+                                else if (c == '0')
+                                        spec.pad = '0';
+                                else
+                                        break;
+                        }
+                        while (c >= '0' && c <= '9') {
+                                spec.width = spec.width * 10 + (c - '0');
+                                c          = fmt_peek(++fmt, in_flash);
+                        }
+                        if (c == '.') {
+                                c = fmt_peek(++fmt, in_flash);
+                                while (c >= '0' && c <= '9') {
+                                        spec.decimals = spec.decimals * 10 + (c - '0');
+                                        c             = fmt_peek(++fmt, in_flash);
+                                }
+                                if (spec.decimals > FMT_DECIMALS_MAX) spec.decimals = FMT_DECIMALS_MAX;
+                        }
+                        if (c == 'l') {
+                                wide = true;
+                                c    = fmt_peek(++fmt, in_flash);
+                        }
+                        if (spec.left) spec.pad = ' ';
+
+                        switch (c) {
+                                case 'c' :
+                                        {
+                                                char ch = (char)va_arg(args, uint16_t);
+                                                fmt_text(out, &ch, 1, false, &spec);
+                                                break;
+                                        }
+                                case 's' :
+                                        {
+                                                const char *str = va_arg(args, const char *);
+                                                if (!str) str = "(null)";
+                                                fmt_text(out, str, string_length(str), false, &spec);
+                                                break;
+                                        }
+                                case 'S' :
+                                        {
+                                                const char *str = va_arg(args, const char *);
+                                                if (str) {
+                                                        fmt_text(out, str, strlen_P(str), true, &spec);
+                                                } else {
+                                                        fmt_text(out, "(null)", 6, false, &spec);
+                                                }
+                                                break;
+                                        }
+                                case 'd' :
+                                case 'i' :
+                                        {
+                                                int32_t val = wide ? va_arg(args, int32_t) : va_arg(args, int16_t);
+                                                bool    neg = val < 0;
+                                                fmt_integer(out, neg ? -(uint32_t)val : (uint32_t)val, neg, 10, &spec, NULL);
+                                                break;
+                                        }
+                                case 'u' :
+                                        {
+                                                uint32_t val = wide ? va_arg(args, uint32_t) : va_arg(args, uint16_t);
+                                                fmt_integer(out, val, false, 10, &spec, NULL);
+                                                break;
+                                        }
+                                case 'b' :
+                                        {
+                                                uint32_t val = wide ? va_arg(args, uint32_t) : va_arg(args, uint16_t);
+                                                fmt_integer(out, val, false, 2, &spec, NULL);
+                                                break;
+                                        }
+                                case 'X' :
+                                        spec.upper = true;
+                                        /* fallthrough */
+                                case 'x' :
+                                        {
+                                                uint32_t val = wide ? va_arg(args, uint32_t) : va_arg(args, uint16_t);
+                                                fmt_integer(out, val, false, 16, &spec, NULL);
+                                                break;
+                                        }
+                                case 'p' :
+                                        {
+                                                void *ptr  = (void *)va_arg(args, void *);
+                                                spec.upper = true;
+                                                fmt_integer(out, (uintptr_t)ptr, false, 16, &spec, "0x");
+                                                break;
+                                        }
+                                case '%' :
+                                        {
+                                                fmt_emit(out, '%');
+                                                break;
+                                        }
+                                default :
+                                        {
+                                                fmt_emit(out, c);
+                                                break;
+                                        }
+                        }
+                } else {
+                        fmt_emit(out, c);
+                }
+                fmt++;
+        }
+        return out->count;
+}
+
+typedef struct {
+        char  *dst;
+        size_t cap;
+        size_t len;
+} FmtBuffer;
+
+static void fmt_put_buffer(void *ctx, char c) {
+        FmtBuffer *buf = ctx;
+        if (buf->len + 1 < buf->cap) buf->dst[buf->len] = c;
+        buf->len++;
+}
+
+static int16_t fmt_vbuffer(char *dst, size_t cap, const char *fmt, va_list args, bool in_flash) {
+        if (!dst && cap) return -1;
+        FmtBuffer buf = {.dst = dst, .cap = cap, .len = 0};
+        FmtOut    out = {.put = fmt_put_buffer, .ctx = &buf, .count = 0};
+        int16_t   len = fmt_format(&out, fmt, args, in_flash);
+        if (cap) dst[buf.len < cap ? buf.len : cap - 1] = '\0';
+        return len;
+}
+
+int16_t fmt_buffer(char *dst, size_t cap, const char *fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        int16_t len = fmt_vbuffer(dst, cap, fmt, args, false);
+        va_end(args);
+        return len;
+}
+
+int16_t fmt_buffer_P(char *dst, size_t cap, const char *fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        int16_t len = fmt_vbuffer(dst, cap, fmt, args, true);
+        va_end(args);
+        return len;
+}
+
+int16_t fmt_vsink(FmtPut put, void *ctx, const char *fmt, va_list args) {
+        if (!put) return -1;
+        FmtOut out = {.put = put, .ctx = ctx, .count = 0};
+        return fmt_format(&out, fmt, args, false);
+}
+
+int16_t fmt_sink(FmtPut put, void *ctx, const char *fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        int16_t len = fmt_vsink(put, ctx, fmt, args);
+        va_end(args);
+        return len;
+}
+
+static void uart_fmt_put(void *ctx, char c) {
+        (void)ctx;
+        uart_tx_enqueue(c);
+}
+
+static int16_t uart_vprintf(const char *fmt, va_list args, bool in_flash) {
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        FmtOut out = {.put = uart_fmt_put, .ctx = NULL, .count = 0};
+        return fmt_format(&out, fmt, args, in_flash);
+}
+
+int16_t uart_printf(const char *fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        int16_t printed = uart_vprintf(fmt, args, false);
+        va_end(args);
+        return printed;
+}
+
+int16_t uart_printf_P(const char *fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        int16_t printed = uart_vprintf(fmt, args, true);
+        va_end(args);
+        return printed;
+}
+
+
+static inline void uart_emit_bytes(const char *s, uint8_t len) {
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        while (len--) uart_tx_enqueue(*s++);
+}
+
+void uart_emit_str(const char *s) {
+        if (!s) return;
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        while (*s) uart_tx_enqueue(*s++);
+}
+
+void uart_emit_flash(PrintFlash s) {
+        if (!s.str) return;
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        char c;
+        while ((c = pgm_read_byte(s.str++))) uart_tx_enqueue(c);
+}
+
+void uart_emit_char(char c) {
+        uart_emit_bytes(&c, 1);
+}
+
+void uart_emit_udec(uint32_t v) {
+        char    buf[10];
+        uint8_t len = fmt_dec(buf + sizeof(buf), v);
+        uart_emit_bytes(buf + sizeof(buf) - len, len);
+}
+
+void uart_emit_dec(int32_t v) {
+        char    buf[11];
+        uint8_t len = fmt_dec(buf + sizeof(buf), v < 0 ? -(uint32_t)v : (uint32_t)v);
+        if (v < 0) buf[sizeof(buf) - ++len] = '-';
+        uart_emit_bytes(buf + sizeof(buf) - len, len);
+}
+
+/* Zero padded to v.digits, upper case, e.g. HEX4(0x2A) prints 002A */
+void uart_emit_hex(PrintHex v) {
+        char    buf[8];
+        uint8_t len = fmt_hex(buf + sizeof(buf), v.value, true);
+        while (len < v.digits && len < sizeof(buf)) buf[sizeof(buf) - ++len] = '0';
+        uart_emit_bytes(buf + sizeof(buf) - len, len);
+}
+
+
+int16_t uart_read(char *buff, size_t bufsize) {
+        if (!buff || bufsize == 0) {
+                return -1;
+        }
+        size_t i = 0;
+        while (i < bufsize) {
+                buff[i++] = uart_getchar();
+        }
+        return i;
+}
+
+int16_t uart_read_until_delimiter(char *buff, size_t bufsize, uint8_t delimiter) {
+        if (!buff || bufsize == 0) {
+                return -1;
+        }
+        size_t i = 0;
+
+        while (i < bufsize - 1) {
+                char c = uart_getchar();
+                if (c == delimiter) break;
+                buff[i++] = c;
+        }
+        buff[i] = '\0';
+        return i;
+}
+
+int16_t uart_write(const char *buff, size_t bufsize) {
+        if (!buff) {
+                return -1;
+        }
+        size_t i = 0;
+        while (i < bufsize) {
+                uart_tx_enqueue(buff[i++]);
+        }
+        return i;
+}
+
+int16_t uart_write_until_delimiter(const char *buff, size_t bufsize, uint8_t delimiter) {
+        if (!buff) {
+                return -1;
+        }
+        size_t i = 0;
+        while (i < bufsize) {
+                if (buff[i] == delimiter) break;
+                uart_tx_enqueue(buff[i++]);
+        }
+        return i;
+}
+
+int16_t uart_getline(char *buff, size_t bufsize) {
+        int16_t len = uart_read_until_delimiter(buff, bufsize, '\n');
+
+        if (len > 0 && buff[len - 1] == '\r') {
+                buff[len - 1] = '\0';
+                len--;
+        }
+        return len;
+}
+
+int16_t uart_getline_echo(char *buff, size_t bufsize) {
+        if (!buff || bufsize == 0) {
+                return -1;
+        }
+        size_t i = 0;
+
+        while (i < bufsize - 1) {
+                char c = uart_getchar();
+                if (c == '\n' && i > 0 && buff[i - 1] == '\r') {
+                        i--; // drop the CR like uart_getline
+                        break;
+                }
+                buff[i++] = c;
+                uart_tx_enqueue(c);
+        }
+        buff[i] = '\0';
+        return i;
+}
+
+int16_t uart_putline(const char *buff) {
+        int16_t written = uart_write(buff, string_length(buff));
+        written += uart_write("\r\n", 2);
+        return written;
+}
+
+int16_t uart_putline_P(const char *buff) {
+        if (!buff) {
+                return -1;
+        }
+        int16_t written = 0;
+        char    c;
+        while ((c = pgm_read_byte(buff++))) {
+                uart_tx_enqueue(c);
+                written++;
+        }
+        written += uart_write("\r\n", 2);
+        return written;
+}
+
+#if UART_FRAME_PAYLOAD_MAX < 1 || UART_FRAME_PAYLOAD_MAX > 250
+#error "UART_FRAME_PAYLOAD_MAX must be between 1 and 250"
+#endif
+
+/*
+ * COBS encoder feeding the transmit queue. A run of non zero bytes has to be
+ * held back until the zero that ends it, or the end of the frame, gives its
+ * length. A frame never exceeds 254 bytes, so the 0xFF "no zero follows" code
+ * is never needed and the run buffer only has to hold one whole frame.
+ */
+#define UART_FRAME_MAX (UART_FRAME_HEADER_SIZE + UART_FRAME_PAYLOAD_MAX + 2)
+
+static uint8_t  uart_frame_run[UART_FRAME_MAX];
+static uint8_t  uart_frame_run_len = 0;
+static uint8_t  uart_frame_len     = 0; // payload bytes written so far
+static uint16_t uart_frame_crc     = 0;
+static uint8_t  uart_frame_seq     = 0;
+
+static void     uart_frame_flush_run(void) {
+        uart_tx_enqueue(uart_frame_run_len + 1);
+        for (uint8_t i = 0; i < uart_frame_run_len; i++) {
+                uart_tx_enqueue(uart_frame_run[i]);
+        }
+        uart_frame_run_len = 0;
+}
+
+static void uart_frame_put(uint8_t b) {
+        if (b) {
+                uart_frame_run[uart_frame_run_len++] = b;
+        } else {
+                uart_frame_flush_run();
+        }
+}
+
+static void uart_frame_put_checked(uint8_t b) {
+        uart_frame_crc = _crc_ccitt_update(uart_frame_crc, b);
+        uart_frame_put(b);
+}
+
+void uart_frame_begin(uint8_t type) {
+        if (!uart_initialized) {
+                uart_init((void *)0);
+        }
+        uart_frame_run_len = 0;
+        uart_frame_len     = 0;
+        uart_frame_crc     = 0xFFFF;
+        uart_frame_put_checked(type);
+        uart_frame_put_checked(uart_frame_seq++);
+}
+
+int16_t uart_frame_write(const void *data, uint8_t len) {
+        if (!data || len > UART_FRAME_PAYLOAD_MAX - uart_frame_len) {
+                return -1;
+        }
+        const uint8_t *bytes = data;
+        for (uint8_t i = 0; i < len; i++) {
+                uart_frame_put_checked(bytes[i]);
+        }
+        uart_frame_len += len;
+        return len;
+}
+
+void uart_frame_end(void) {
+        uint16_t crc = uart_frame_crc;
+        uart_frame_put(crc & 0xFF);
+        uart_frame_put(crc >> 8);
+        uart_frame_flush_run();
+        uart_tx_enqueue(0x00);
+}
+
+int16_t uart_frame_send(uint8_t type, const void *payload, uint8_t len) {
+        if ((!payload && len) || len > UART_FRAME_PAYLOAD_MAX) {
+                return -1;
+        }
+        uart_frame_begin(type);
+        if (len) uart_frame_write(payload, len);
+        uart_frame_end();
+        return len;
+}
+
+/*
+ * Shared digit scanner: blanks, an optional sign when negative is given, a
+ * 0x or 0b prefix when base allows it, then digits until the first byte that
+ * is not one or len bytes were read. Bases 10 and 16 get their own loops so
+ * the common cases need no division for the overflow check.
+ */
+static int16_t parse_digits(const char *s, uint16_t len, uint8_t base, uint32_t limit, bool *negative, uint32_t *value) {
+        uint16_t i = 0;
+        while (i < len && (s[i] == ' ' || s[i] == '\t')) i++;
+
+        bool neg = false;
+        if (negative && i < len && (s[i] == '-' || s[i] == '+')) {
+                neg = (s[i] == '-');
+                i++;
+        }
+        if (i + 2 < len && s[i] == '0') {
+                char prefix = s[i + 1] | 0x20;
+                if (prefix == 'x' && (base == 0 || base == 16) && is_xdigit(s[i + 2])) {
+                        base = 16;
+                        i += 2;
+                } else if (prefix == 'b' && (base == 0 || base == 2) && (s[i + 2] == '0' || s[i + 2] == '1')) {
+                        base = 2;
+                        i += 2;
+                }
+        }
+        if (base == 0) base = 10;
+        if (base < 2 || base > 36) return PARSE_NO_DIGITS;
+        if (neg) limit++; // one more on the negative side of two's complement
+
+        uint16_t start  = i;
+        uint32_t result = 0;
+        if (base == 10) {
+                for (; i < len; i++) {
+                        uint8_t d = s[i] - '0';
+                        if (d > 9) break;
+                        if (result > UINT32_MAX / 10 || (result == UINT32_MAX / 10 && d > UINT32_MAX % 10)) return PARSE_OVERFLOW;
+                        result = result * 10 + d;
+                }
+        } else if (base == 16) {
+                for (; i < len; i++) {
+                        uint8_t d = s[i] - '0';
+                        if (d > 9) {
+                                d = (s[i] | 0x20) - 'a' + 10;
+                                if (d < 10 || d > 15) break;
+                        }
+                        if (result >> 28) return PARSE_OVERFLOW;
+                        result = (result << 4) | d;
+                }
+        } else {
+                for (; i < len; i++) {
+                        char    c = s[i];
+                        uint8_t d = 0xFF;
+                        if (c >= '0' && c <= '9')
+                                d = c - '0';
+                        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+                                d = (c | 0x20) - 'a' + 10;
+                        if (d >= base) break;
+                        if (result > (UINT32_MAX - d) / base) return PARSE_OVERFLOW;
+                        result = result * base + d;
+                }
+        }
+        if (i == start) return PARSE_NO_DIGITS;
+        if (result > limit) return PARSE_OVERFLOW;
+        if (negative) *negative = neg;
+        *value = result;
+        return i;
+}
+
+static int16_t parse_unsigned_limit(const char *str, uint8_t base, uint32_t limit, uint32_t *value) {
+        if (!str) return PARSE_NO_DIGITS;
+        return parse_digits(str, UINT16_MAX, base, limit, NULL, value);
+}
+
+static int16_t parse_signed_limit(const char *str, uint8_t base, uint32_t limit, int32_t *value) {
+        if (!str) return PARSE_NO_DIGITS;
+        bool     negative;
+        uint32_t magnitude;
+        int16_t  used = parse_digits(str, UINT16_MAX, base, limit, &negative, &magnitude);
+        if (used >= 0) *value = negative ? (int32_t)(0 - magnitude) : (int32_t)magnitude;
+        return used;
+}
+
+int16_t parse_u8(const char *str, uint8_t base, uint8_t *value) {
+        uint32_t v;
+        int16_t  used = parse_unsigned_limit(str, base, UINT8_MAX, &v);
+        if (used >= 0 && value) *value = v;
+        return used;
+}
+
+int16_t parse_u16(const char *str, uint8_t base, uint16_t *value) {
+        uint32_t v;
+        int16_t  used = parse_unsigned_limit(str, base, UINT16_MAX, &v);
+        if (used >= 0 && value) *value = v;
+        return used;
+}
+
+int16_t parse_u32(const char *str, uint8_t base, uint32_t *value) {
+        uint32_t v;
+        int16_t  used = parse_unsigned_limit(str, base, UINT32_MAX, &v);
+        if (used >= 0 && value) *value = v;
+        return used;
+}
+
+int16_t parse_i8(const char *str, uint8_t base, int8_t *value) {
+        int32_t v;
+        int16_t used = parse_signed_limit(str, base, INT8_MAX, &v);
+        if (used >= 0 && value) *value = v;
+        return used;
+}
+
+int16_t parse_i16(const char *str, uint8_t base, int16_t *value) {
+        int32_t v;
+        int16_t used = parse_signed_limit(str, base, INT16_MAX, &v);
+        if (used >= 0 && value) *value = v;
+        return used;
+}
+
+int16_t parse_i32(const char *str, uint8_t base, int32_t *value) {
+        int32_t v;
+        int16_t used = parse_signed_limit(str, base, INT32_MAX, &v);
+        if (used >= 0 && value) *value = v;
+        return used;
+}
+
+int16_t parse_number(const char *number, uint8_t base) {
+        int16_t value = 0;
+        if (base < 2) return 0;
+        parse_i16(number, base, &value);
+        return value;
+}
+
+uint16_t parse_unsigned(const char *number, uint8_t base) {
+        uint16_t value = 0;
+        if (base < 2) return 0;
+        parse_u16(number, base, &value);
+        return value;
+}
+
+
+const uint8_t char_class_table[256] PROGMEM = {
+    [0x00 ... 0x08] = CHAR_CLASS_CNTRL,
+    [0x09 ... 0x0D] = CHAR_CLASS_CNTRL | CHAR_CLASS_SPACE,
+    [0x0E ... 0x1F] = CHAR_CLASS_CNTRL,
+    [' ']           = CHAR_CLASS_PRINT | CHAR_CLASS_SPACE,
+    ['!' ... '/']   = CHAR_CLASS_PRINT | CHAR_CLASS_PUNCT,
+    ['0' ... '9']   = CHAR_CLASS_PRINT | CHAR_CLASS_DIGIT,
+    [':' ... '@']   = CHAR_CLASS_PRINT | CHAR_CLASS_PUNCT,
+    ['A' ... 'F']   = CHAR_CLASS_PRINT | CHAR_CLASS_UPPER | CHAR_CLASS_XALPHA,
+    ['G' ... 'Z']   = CHAR_CLASS_PRINT | CHAR_CLASS_UPPER,
+    ['[' ... '`']   = CHAR_CLASS_PRINT | CHAR_CLASS_PUNCT,
+    ['a' ... 'f']   = CHAR_CLASS_PRINT | CHAR_CLASS_LOWER | CHAR_CLASS_XALPHA,
+    ['g' ... 'z']   = CHAR_CLASS_PRINT | CHAR_CLASS_LOWER,
+    ['{' ... '~']   = CHAR_CLASS_PRINT | CHAR_CLASS_PUNCT,
+    [0x7F]          = CHAR_CLASS_CNTRL,
+};
+
+
+/* Helper: check if a character is in a given set */
+static int32_t is_in_set(char c, const char *set) {
+        while (*set) {
+                if (c == *set) return 1;
+                set++;
+        }
+        return 0;
+}
+
+static char to_lower(char c) {
+        if (c >= 'A' && c <= 'Z') return c + ('a' - 'A');
+        return c;
+}
+
+int16_t string_first_index_of(const char *str, char c) {
+        if (!str) return -1;
+        for (int16_t i = 0; str[i]; i++) {
+                if (str[i] == c) return i;
+        }
+        return -1;
+}
+
+int16_t string_last_index_of(const char *str, char c) {
+        if (!str) return -1;
+        int16_t last = -1;
+        for (int16_t i = 0; str[i]; i++) {
+                if (str[i] == c) last = i;
+        }
+        return last;
+}
+
+int16_t string_first_index_of_none(const char *str, const char *set) {
+        if (!str || !set) return -1;
+        for (int16_t i = 0; str[i]; i++) {
+                if (!is_in_set(str[i], set)) return i;
+        }
+        return -1;
+}
+
+int16_t string_last_index_of_none(const char *str, const char *set) {
+        if (!str || !set) return -1;
+        int16_t last = -1;
+        for (int16_t i = 0; str[i]; i++) {
+                if (!is_in_set(str[i], set)) last = i;
+        }
+        return last;
+}
+
+int16_t search_pattern_init(SearchPattern *pat, const char *needle) {
+        if (!pat || !needle) return -1;
+        uint16_t len = 0;
+        while (needle[len]) {
+                if (++len > 255) return -1;
+        }
+        pat->needle = needle;
+        pat->len    = len;
+        for (uint8_t i = 0; i < SEARCH_SHIFT_SIZE; i++) pat->shift[i] = len;
+        /* later bytes overwrite earlier ones in a shared bucket, keeping the smaller and always safe shift */
+        for (uint8_t i = 0; i + 1 < len; i++) {
+                pat->shift[(uint8_t)needle[i] & (SEARCH_SHIFT_SIZE - 1)] = len - 1 - i;
+        }
+        return 0;
+}
+
+int16_t search_pattern_find(const SearchPattern *pat, const char *hay, uint16_t hay_len) {
+        if (!pat || !hay || hay_len > INT16_MAX) return -1; // a match past it would not fit the result
+        uint8_t m = pat->len;
+        if (!m) return 0;
+        if (hay_len < m) return -1;
+
+        const char *needle = pat->needle;
+        char        last   = needle[m - 1];
+        uint16_t    end    = hay_len - m;
+        uint16_t    pos    = 0;
+        while (pos <= end) {
+                char c = hay[pos + m - 1];
+                if (c == last) {
+                        uint8_t j = 0;
+                        while (j < m - 1 && hay[pos + j] == needle[j]) j++;
+                        if (j == m - 1) return pos;
+                }
+                pos += pat->shift[(uint8_t)c & (SEARCH_SHIFT_SIZE - 1)];
+        }
+        return -1;
+}
+
+int16_t string_search_bounded(const char *hay, uint16_t hay_len, const char *needle) {
+        SearchPattern pat;
+        if (search_pattern_init(&pat, needle) < 0) return -1;
+        return search_pattern_find(&pat, hay, hay_len);
+}
+
+/* Byte by byte scan for what Horspool cannot index: needles over 255 bytes, haystacks over 32767 */
+static char *string_search_scan(const char *str, const char *substr) {
+        for (int32_t i = 0; str[i]; i++) {
+                int32_t j = 0;
+                while (str[i + j] && substr[j] && str[i + j] == substr[j]) j++;
+                if (!substr[j]) return (char *)(str + i);
+        }
+        return NULL;
+}
+
+char *string_search_substring(const char *str, const char *substr) {
+        if (!str || !substr) return NULL;
+        if (!*substr) return (char *)str; // empty substring is found at start
+        if (!substr[1]) return string_search_byte(str, *substr);
+
+        SearchPattern pat;
+        uint16_t      hay_len = string_length(str);
+        if (hay_len > INT16_MAX || search_pattern_init(&pat, substr) < 0) return string_search_scan(str, substr);
+        int16_t at = search_pattern_find(&pat, str, hay_len);
+        return at < 0 ? NULL : (char *)(str + at);
+}
+
+char *string_search_byte(const char *str, char c) {
+        if (!str) return NULL;
+        while (*str) {
+                if (*str == c) return (char *)str;
+                str++;
+        }
+        return NULL;
+}
+
+int16_t string_contains(const char *str, const char *substr) {
+        char *pos = string_search_substring(str, substr);
+        if (pos) return (int16_t)(pos - str);
+        return -1;
+}
+
+int16_t string_concat(char *dest, const char *src) {
+        if (!dest || !src) return -1;
+        int16_t i = 0;
+        while (dest[i]) i++;
+        int16_t j = 0;
+        while (src[j]) {
+                dest[i++] = src[j++];
+        }
+        dest[i] = '\0';
+        return i;
+}
+
+int16_t string_copy(char *dest, const char *src) {
+        if (!dest || !src) return -1;
+        int16_t i = 0;
+        while (src[i]) {
+                dest[i] = src[i];
+                i++;
+        }
+        dest[i] = '\0';
+        return i;
+}
+
+int16_t string_reverse(char *str) {
+        if (!str) return -1;
+        int16_t len = 0;
+        while (str[len]) len++;
+        for (int16_t i = 0; i < len / 2; i++) {
+                char tmp         = str[i];
+                str[i]           = str[len - 1 - i];
+                str[len - 1 - i] = tmp;
+        }
+        return len;
+}
+
+int16_t string_compare(const char *s1, const char *s2) {
+        if (!s1 || !s2) return (s1 == s2) ? 0 : (s1 ? 1 : -1);
+        while (*s1 && (*s1 == *s2)) {
+                s1++;
+                s2++;
+        }
+        return (int16_t)((uint8_t)*s1 - (uint8_t)*s2);
+}
+
+int16_t string_case_compare(const char *s1, const char *s2) {
+        if (!s1 || !s2) return (s1 == s2) ? 0 : (s1 ? 1 : -1);
+        while (*s1 && *s2) {
+                char c1 = to_lower(*s1);
+                char c2 = to_lower(*s2);
+                if (c1 != c2) return (int16_t)(c1 - c2);
+                s1++;
+                s2++;
+        }
+        return (int16_t)(to_lower(*s1) - to_lower(*s2));
+}
+
+int16_t string_starts_with(const char *str, const char *prefix) {
+        if (!str || !prefix) return 0;
+        while (*prefix) {
+                if (*str != *prefix) return 0;
+                str++;
+                prefix++;
+        }
+        return 1;
+}
+
+int16_t string_ends_with(const char *str, const char *suffix) {
+        if (!str || !suffix) return 0;
+        int16_t str_len = 0, suffix_len = 0;
+        while (str[str_len]) str_len++;
+        while (suffix[suffix_len]) suffix_len++;
+        if (suffix_len > str_len) return 0;
+        for (int16_t i = 0; i < suffix_len; i++) {
+                if (str[str_len - suffix_len + i] != suffix[i]) return 0;
+        }
+        return 1;
+}
+
+int16_t string_count(const char *str, char ch) {
+        if (!str) return 0;
+        int16_t count = 0;
+        for (int16_t i = 0; str[i]; i++) {
+                if (str[i] == ch) count++;
+        }
+        return count;
+}
+
+
+int16_t string_spn(const char *s, const char *accept) {
+        if (!s || !accept) return 0;
+        int16_t count = 0;
+        while (s[count] && is_in_set(s[count], accept)) count++;
+        return count;
+}
+
+int16_t string_cspn(const char *s, const char *reject) {
+        if (!s || !reject) return 0;
+        int16_t count = 0;
+        while (s[count] && !is_in_set(s[count], reject)) count++;
+        return count;
+}
+
+/* Shared by string_tokenize() and string_tokenize_set() so delimiters can change mid string */
+static char *string_token_next = NULL;
+
+char        *string_tokenize(char *str, const char *delim) {
+        if (str) string_token_next = str;
+        if (!string_token_next) return NULL;
+
+        while (*string_token_next && is_in_set(*string_token_next, delim)) string_token_next++;
+
+        if (!*string_token_next) {
+                string_token_next = NULL;
+                return NULL;
+        }
+
+        char *token = string_token_next;
+
+        while (*string_token_next && !is_in_set(*string_token_next, delim)) string_token_next++;
+
+        if (*string_token_next) {
+                *string_token_next = '\0';
+                string_token_next++;
+        }
+        return token;
+}
+
+void charset_init(CharSet *set, const char *chars) {
+        if (!set) return;
+        for (uint8_t i = 0; i < sizeof(set->bits); i++) set->bits[i] = 0;
+        if (!chars) return;
+        while (*chars) charset_add(set, *chars++);
+}
+
+void charset_add(CharSet *set, uint8_t c) {
+        set->bits[c >> 3] |= (1 << (c & 7));
+}
+
+int16_t string_spn_set(const char *s, const CharSet *accept) {
+        if (!s || !accept) return 0;
+        int16_t count = 0;
+        while (s[count] && charset_has(accept, s[count])) count++;
+        return count;
+}
+
+int16_t string_cspn_set(const char *s, const CharSet *reject) {
+        if (!s || !reject) return 0;
+        int16_t count = 0;
+        while (s[count] && !charset_has(reject, s[count])) count++;
+        return count;
+}
+
+int16_t string_first_index_of_none_set(const char *str, const CharSet *set) {
+        if (!str || !set) return -1;
+        for (int16_t i = 0; str[i]; i++) {
+                if (!charset_has(set, str[i])) return i;
+        }
+        return -1;
+}
+
+int16_t string_last_index_of_none_set(const char *str, const CharSet *set) {
+        if (!str || !set) return -1;
+        int16_t last = -1;
+        for (int16_t i = 0; str[i]; i++) {
+                if (!charset_has(set, str[i])) last = i;
+        }
+        return last;
+}
+
+char *string_tokenize_set(char *str, const CharSet *delim) {
+        if (str) string_token_next = str;
+        if (!string_token_next || !delim) return NULL;
+
+        string_token_next += string_spn_set(string_token_next, delim);
+        if (!*string_token_next) {
+                string_token_next = NULL;
+                return NULL;
+        }
+
+        char *token = string_token_next;
+        string_token_next += string_cspn_set(string_token_next, delim);
+        if (*string_token_next) {
+                *string_token_next = '\0';
+                string_token_next++;
+        }
+        return token;
+}
+
+Span span_from(const char *str) {
+        uint8_t len = 0;
+        if (!str) return span_make("", 0);
+        while (str[len] && len < 255) len++;
+        return span_make(str, len);
+}
+
+Span span_trim(Span s) {
+        while (s.len && is_whitespace(*s.p)) {
+                s.p++;
+                s.len--;
+        }
+        while (s.len && is_whitespace(s.p[s.len - 1])) s.len--;
+        return s;
+}
+
+/* Returns the text before the first delim and leaves rest after it, or takes all of rest */
+Span span_split(Span *rest, char delim) {
+        Span head = *rest;
+        for (uint8_t i = 0; i < rest->len; i++) {
+                if (rest->p[i] == delim) {
+                        head.len = i;
+                        *rest    = span_slice(*rest, i + 1, 255);
+                        return head;
+                }
+        }
+        *rest = span_make(rest->p + rest->len, 0);
+        return head;
+}
+
+bool span_next_token(Span *rest, const CharSet *delim, Span *token) {
+        if (!rest || !delim || !token) return false;
+        const char *p   = rest->p;
+        uint8_t     len = rest->len;
+        while (len && charset_has(delim, *p)) {
+                p++;
+                len--;
+        }
+        uint8_t n = 0;
+        while (n < len && !charset_has(delim, p[n])) n++;
+        *token = span_make(p, n);
+        *rest  = span_make(p + n, len - n);
+        return n != 0;
+}
+
+int16_t span_compare(Span a, Span b) {
+        uint8_t n = a.len < b.len ? a.len : b.len;
+        for (uint8_t i = 0; i < n; i++) {
+                if (a.p[i] != b.p[i]) return (int16_t)((uint8_t)a.p[i] - (uint8_t)b.p[i]);
+        }
+        return (int16_t)a.len - b.len;
+}
+
+int16_t span_case_compare(Span a, Span b) {
+        uint8_t n = a.len < b.len ? a.len : b.len;
+        for (uint8_t i = 0; i < n; i++) {
+                char c1 = to_lower(a.p[i]);
+                char c2 = to_lower(b.p[i]);
+                if (c1 != c2) return (int16_t)(c1 - c2);
+        }
+        return (int16_t)a.len - b.len;
+}
+
+bool span_equals_P(Span s, const char *str) {
+        if (!str) return false;
+        for (uint8_t i = 0; i < s.len; i++) {
+                if (pgm_read_byte(str + i) != (uint8_t)s.p[i]) return false;
+        }
+        return pgm_read_byte(str + s.len) == '\0';
+}
+
+bool span_case_equals_P(Span s, const char *str) {
+        if (!str) return false;
+        for (uint8_t i = 0; i < s.len; i++) {
+                if (to_lower(pgm_read_byte(str + i)) != to_lower(s.p[i])) return false;
+        }
+        return pgm_read_byte(str + s.len) == '\0';
+}
+
+/* parse_digits skips leading blanks, a span has to start right on the sign or first digit */
+static bool span_starts_number(Span s, uint8_t base, bool sign) {
+        char    c = s.p[0];
+        uint8_t d = c - '0';
+        if (d > 9) d = (uint8_t)((c | 0x20) - 'a') < 26 ? (c | 0x20) - 'a' + 10 : 0xFF;
+        return d < base || (sign && (c == '-' || c == '+'));
+}
+
+/* The whole span must be one number in base, returns the length parsed or -1 on bad input or overflow */
+int16_t span_parse_unsigned(Span s, uint8_t base, uint32_t *value) {
+        if (!value || !s.len || base < 2 || !span_starts_number(s, base, false)) return -1;
+        uint32_t result;
+        if (parse_digits(s.p, s.len, base, UINT32_MAX, NULL, &result) != s.len) return -1;
+        *value = result;
+        return s.len;
+}
+
+int16_t span_parse_signed(Span s, uint8_t base, int32_t *value) {
+        if (!value || !s.len || base < 2 || !span_starts_number(s, base, true)) return -1;
+        bool     negative;
+        uint32_t magnitude;
+        if (parse_digits(s.p, s.len, base, INT32_MAX, &negative, &magnitude) != s.len) return -1;
+        *value = negative ? (int32_t)(0 - magnitude) : (int32_t)magnitude;
+        return s.len;
+}
+
+/* Copies the span out as a C string, -1 and nothing written when it does not fit */
+int16_t span_copy(Span s, char *dst, size_t dstsize) {
+        if (!dst || s.len >= dstsize) return -1;
+        for (uint8_t i = 0; i < s.len; i++) dst[i] = s.p[i];
+        dst[s.len] = '\0';
+        return s.len;
+}
+
+void string_builder_init(StringBuilder *sb, char *buf, uint8_t cap) {
+        sb->buf = buf;
+        sb->cap = buf ? cap : 0;
+        string_builder_reset(sb);
+}
+
+void string_builder_reset(StringBuilder *sb) {
+        sb->len      = 0;
+        sb->overflow = false;
+        if (sb->cap) sb->buf[0] = '\0';
+}
+
+static inline uint8_t string_builder_space(const StringBuilder *sb) {
+        return sb->cap ? sb->cap - 1 - sb->len : 0;
+}
+
+/* How much of want fits before the NUL, flags overflow when not all of it */
+static uint8_t string_builder_room(StringBuilder *sb, uint16_t want) {
+        uint8_t room = string_builder_space(sb);
+        if (want <= room) return want;
+        sb->overflow = true;
+        return room;
+}
+
+static bool string_builder_put(StringBuilder *sb, const char *s, uint16_t len, bool in_flash) {
+        uint8_t n   = string_builder_room(sb, len);
+        char   *dst = sb->buf + sb->len;
+        for (uint8_t i = 0; i < n; i++) dst[i] = in_flash ? pgm_read_byte(&s[i]) : s[i];
+        sb->len += n;
+        if (sb->cap) sb->buf[sb->len] = '\0';
+        return n == len;
+}
+
+bool string_builder_append_char(StringBuilder *sb, char c) {
+        return string_builder_put(sb, &c, 1, false);
+}
+
+bool string_builder_append_str(StringBuilder *sb, const char *s) {
+        if (!s) return false;
+        uint8_t room = string_builder_space(sb) + 1; // one more byte tells a cut from an exact fit
+        uint8_t len  = 0;
+        while (len < room && s[len]) len++;
+        return string_builder_put(sb, s, len, false);
+}
+
+bool string_builder_append_str_P(StringBuilder *sb, const char *s) {
+        if (!s) return false;
+        uint8_t room = string_builder_space(sb) + 1;
+        uint8_t len  = 0;
+        while (len < room && pgm_read_byte(&s[len])) len++;
+        return string_builder_put(sb, s, len, true);
+}
+
+bool string_builder_append_span(StringBuilder *sb, Span s) {
+        return string_builder_put(sb, s.p, s.len, false);
+}
+
+bool string_builder_append_uint(StringBuilder *sb, uint32_t value) {
+        char    buf[10];
+        uint8_t len = fmt_dec(buf + sizeof(buf), value);
+        return string_builder_put(sb, buf + sizeof(buf) - len, len, false);
+}
+
+bool string_builder_append_int(StringBuilder *sb, int32_t value) {
+        char    buf[11];
+        uint8_t len = fmt_dec(buf + sizeof(buf), value < 0 ? -(uint32_t)value : (uint32_t)value);
+        if (value < 0) buf[sizeof(buf) - ++len] = '-';
+        return string_builder_put(sb, buf + sizeof(buf) - len, len, false);
+}
+
+/* Upper case, zero padded to digits like HEX2/HEX4/HEX8 */
+bool string_builder_append_hex(StringBuilder *sb, uint32_t value, uint8_t digits) {
+        char    buf[8];
+        uint8_t len = fmt_hex(buf + sizeof(buf), value, true);
+        while (len < digits && len < sizeof(buf)) buf[sizeof(buf) - ++len] = '0';
+        return string_builder_put(sb, buf + sizeof(buf) - len, len, false);
+}
+
+int16_t string_builder_send(const StringBuilder *sb) {
+        if (!sb || !sb->buf) return -1;
+        return uart_write(sb->buf, sb->len);
+}
+
+static uint8_t command_slot(char first, char last, uint8_t len) {
+        return ((uint8_t)((first | 0x20) << 2) + (uint8_t)(last | 0x20) + len) & (COMMAND_SLOTS - 1);
+}
+
+/* -1 when two names share a slot, the set is then unusable */
+int16_t command_set_init(CommandSet *set, const Command *table, uint8_t count) {
+        if (!set || !table) return -1;
+        set->table = table;
+        set->count = 0;
+        for (uint8_t i = 0; i < COMMAND_SLOTS; i++) set->slots[i] = 0xFF;
+        for (uint8_t i = 0; i < count; i++) {
+                const char *name = table[i].name;
+                uint8_t     len  = 0;
+                while (len < COMMAND_NAME_SIZE && pgm_read_byte(&name[len])) len++;
+                if (!len || len == COMMAND_NAME_SIZE) return -1;
+                uint8_t slot = command_slot(pgm_read_byte(&name[0]), pgm_read_byte(&name[len - 1]), len);
+                if (set->slots[slot] != 0xFF) return -1;
+                set->slots[slot] = i;
+        }
+        set->count = count;
+        return count;
+}
+
+int16_t command_dispatch(const CommandSet *set, Span line, const CharSet *delim) {
+        Span name;
+        if (!set || !span_next_token(&line, delim, &name)) return COMMAND_EMPTY;
+
+        uint8_t index = set->slots[command_slot(name.p[0], name.p[name.len - 1], name.len)];
+        if (index >= set->count) return COMMAND_UNKNOWN;
+        const Command *entry = &set->table[index];
+        if (!span_case_equals_P(name, entry->name)) return COMMAND_UNKNOWN;
+
+        Span    args[COMMAND_ARGS_MAX + 1];
+        uint8_t argc = 0;
+        while (argc <= COMMAND_ARGS_MAX && span_next_token(&line, delim, &args[argc])) argc++;
+
+        if (argc != pgm_read_byte(&entry->argc)) {
+                uart_printf_F("Usage: %S %S\r\n", entry->name, entry->help);
+                return COMMAND_USAGE;
+        }
+        CommandHandler handler;
+        memcpy_P(&handler, &entry->handler, sizeof(handler));
+        handler(args, argc);
+        return 0;
+}
+
+void command_help(const CommandSet *set) {
+        if (!set) return;
+        for (uint8_t i = 0; i < set->count; i++) uart_printf_F("%S %S\r\n", set->table[i].name, set->table[i].help);
+}
+
+int16_t string_length(const char *s) {
+        if (!s) return 0;
+        uint16_t i = 0;
+        for (; s[i]; i++)
+                ;
+        return i;
+}
+
+
+
+void uart_putchar(uint8_t c) {
+        uart_tx_enqueue(c);
+}
+
+uint8_t uart_getchar() {
+        int16_t c;
+        while ((c = uart_try_getchar()) < 0)
+                ;
+        return c;
+}
+
+#define LINE_ESC_NONE    0
+#define LINE_ESC_START   1 // got ESC
+#define LINE_ESC_CSI     2 // got ESC [
+#define LINE_ESC_NUMERIC 3 // got ESC [ digits, waiting for '~'
+
+#if LINE_HISTORY_SIZE > 255
+#error "LINE_HISTORY_SIZE must fit in a uint8_t"
+#endif
+
+#if LINE_HISTORY_SIZE > 0
+/* Previous lines, oldest first, each NUL terminated */
+static char    line_history[LINE_HISTORY_SIZE];
+static uint8_t line_history_used = 0;
+
+static void    line_history_push(const char *line, uint8_t len) {
+        if (!len || len + 1 > LINE_HISTORY_SIZE) return;
+        while (line_history_used + len + 1 > LINE_HISTORY_SIZE) {
+                uint8_t oldest = string_length(line_history) + 1;
+                line_history_used -= oldest;
+                for (uint8_t i = 0; i < line_history_used; i++) line_history[i] = line_history[i + oldest];
+        }
+        for (uint8_t i = 0; i < len; i++) line_history[line_history_used++] = line[i];
+        line_history[line_history_used++] = '\0';
+}
+
+/* n-th most recent entry, 1 being the last line entered */
+static const char *line_history_get(uint8_t n) {
+        uint8_t end = line_history_used;
+        while (end && n--) {
+                uint8_t start = end - 1;
+                while (start && line_history[start - 1]) start--;
+                if (!n) return &line_history[start];
+                end = start;
+        }
+        return NULL;
+}
+#endif
+
+static void line_cursor_left(uint8_t n) {
+        if (!n) return;
+        if (n == 1) {
+                uart_putchar('\b');
+                return;
+        }
+        char    buf[3];
+        uint8_t len = fmt_dec(buf + sizeof(buf), n);
+        uart_write("\033[", 2);
+        uart_write(buf + sizeof(buf) - len, len);
+        uart_putchar('D');
+}
+
+/* Redraws from the cursor to the end of the line, then puts the cursor back */
+static void line_redraw_tail(LineEditor *ed, uint8_t erase) {
+        uart_write(ed->buf + ed->cursor, ed->len - ed->cursor);
+        for (uint8_t i = 0; i < erase; i++) uart_putchar(' ');
+        line_cursor_left(ed->len - ed->cursor + erase);
+}
+
+static void line_replace(LineEditor *ed, const char *text) {
+        uint8_t old_len = ed->len;
+        uint8_t len     = 0;
+
+        line_cursor_left(ed->cursor);
+        while (text[len] && len + 1 < ed->cap) {
+                ed->buf[len] = text[len];
+                len++;
+        }
+        ed->len = ed->cursor = len;
+        uart_write(ed->buf, len);
+        if (old_len > len) uart_write("\033[K", 3);
+}
+
+void line_editor_init(LineEditor *ed, char *buf, uint8_t cap) {
+        if (!ed) return;
+        ed->buf     = buf;
+        ed->cap     = cap;
+        ed->len     = 0;
+        ed->cursor  = 0;
+        ed->esc     = LINE_ESC_NONE;
+        ed->esc_arg = 0;
+        ed->recall  = 0;
+        ed->skip_lf = false;
+        if (buf && cap) buf[0] = '\0';
+}
+
+static void line_key(LineEditor *ed, char key) {
+        switch (key) {
+                case 'D' : // left
+                        if (ed->cursor) {
+                                ed->cursor--;
+                                uart_putchar('\b');
+                        }
+                        break;
+                case 'C' : // right
+                        if (ed->cursor < ed->len) uart_putchar(ed->buf[ed->cursor++]);
+                        break;
+                case 'H' : // home
+                        line_cursor_left(ed->cursor);
+                        ed->cursor = 0;
+                        break;
+                case 'F' : // end
+                        uart_write(ed->buf + ed->cursor, ed->len - ed->cursor);
+                        ed->cursor = ed->len;
+                        break;
+                case '~' : // delete under the cursor
+                        if (ed->cursor < ed->len) {
+                                ed->len--;
+                                for (uint8_t i = ed->cursor; i < ed->len; i++) ed->buf[i] = ed->buf[i + 1];
+                                line_redraw_tail(ed, 1);
+                        }
+                        break;
+#if LINE_HISTORY_SIZE > 0
+                case 'A' : // up
+                case 'B' : // down
+                        {
+                                uint8_t     n    = key == 'A' ? ed->recall + 1 : ed->recall - 1;
+                                const char *text = "";
+                                if (key == 'B' && !ed->recall) break;
+                                if (n) {
+                                        text = line_history_get(n);
+                                        if (!text) break;
+                                }
+                                ed->recall = n;
+                                line_replace(ed, text);
+                                break;
+                        }
+#endif
+        }
+}
+
+/* Processes one received byte, returns the line length once Enter is seen */
+int16_t line_editor_feed(LineEditor *ed, char c) {
+        if (!ed || !ed->buf || ed->cap < 2) return -1;
+
+        if (ed->esc == LINE_ESC_START) {
+                ed->esc = c == '[' ? LINE_ESC_CSI : LINE_ESC_NONE;
+                return -1;
+        }
+        if (ed->esc == LINE_ESC_CSI || ed->esc == LINE_ESC_NUMERIC) {
+                if (c >= '0' && c <= '9') {
+                        ed->esc_arg = ed->esc == LINE_ESC_NUMERIC ? ed->esc_arg * 10 + (c - '0') : c - '0';
+                        ed->esc     = LINE_ESC_NUMERIC;
+                        return -1;
+                }
+                if (c == '~') {
+                        /* VT220 keys: 1/7 home, 4/8 end, 3 delete */
+                        if (ed->esc_arg == 1 || ed->esc_arg == 7)
+                                c = 'H';
+                        else if (ed->esc_arg == 4 || ed->esc_arg == 8)
+                                c = 'F';
+                        else if (ed->esc_arg != 3)
+                                c = 0;
+                }
+                ed->esc = LINE_ESC_NONE;
+                line_key(ed, c);
+                return -1;
+        }
+
+        /* the '\n' of a "\r\n" pair must not submit an empty line */
+        if (c == '\n' && ed->skip_lf) {
+                ed->skip_lf = false;
+                return -1;
+        }
+        ed->skip_lf = (c == '\r');
+
+        switch (c) {
+                case '\r' :
+                case '\n' :
+                        {
+                                int16_t len = ed->len;
+                                ed->buf[len] = '\0';
+                                uart_write("\r\n", 2);
+#if LINE_HISTORY_SIZE > 0
+                                line_history_push(ed->buf, len);
+#endif
+                                ed->len = ed->cursor = ed->recall = 0;
+                                return len;
+                        }
+                case '\033' :
+                        ed->esc = LINE_ESC_START;
+                        return -1;
+                case '\b' :
+                case 127 :
+                        if (ed->cursor) {
+                                ed->cursor--;
+                                ed->len--;
+                                for (uint8_t i = ed->cursor; i < ed->len; i++) ed->buf[i] = ed->buf[i + 1];
+                                uart_putchar('\b');
+                                line_redraw_tail(ed, 1);
+                        }
+                        return -1;
+                case 1 : // Ctrl-A
+                        line_key(ed, 'H');
+                        return -1;
+                case 5 : // Ctrl-E
+                        line_key(ed, 'F');
+                        return -1;
+        }
+
+        if (!is_print(c) || ed->len + 1 >= ed->cap) return -1;
+        for (uint8_t i = ed->len; i > ed->cursor; i--) ed->buf[i] = ed->buf[i - 1];
+        ed->buf[ed->cursor] = c;
+        ed->len++;
+        uart_putchar(c);
+        ed->cursor++;
+        if (ed->cursor < ed->len) line_redraw_tail(ed, 0);
+        ed->buf[ed->len] = '\0';
+        return -1;
+}
+
+int16_t line_editor_poll(LineEditor *ed) {
+        int16_t c;
+        while ((c = uart_try_getchar()) >= 0) {
+                int16_t len = line_editor_feed(ed, c);
+                if (len >= 0) return len;
+        }
+        return -1;
+}
+
+/* Blocking wrapper kept for the existing mains, edits straight into buffer */
+int16_t readline_echo_back(char *buffer, size_t busize) {
+        static bool skip_lf = false; // a "\r\n" may end after the editor returned
+        if (!buffer || !busize) return -1;
+        LineEditor ed;
+        int16_t    len;
+
+        line_editor_init(&ed, buffer, busize > 255 ? 255 : busize);
+        ed.skip_lf = skip_lf;
+        while ((len = line_editor_poll(&ed)) < 0)
+                ;
+        skip_lf = ed.skip_lf;
+        return len;
+}
+
+/* Returns to column 0 and erases the line, count is kept for compatibility */
+int16_t clear_line(uint16_t count) {
+        (void)count;
+        uart_write("\r\033[K", 4);
+        return 0;
+}
@@ -0,0 +1,631 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   libc.h                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: pollivie <pollivie.student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2025/03/03 21:00:56 by pollivie          #+#    #+#             */
+/*   Updated: 2025/03/03 21:00:56 by pollivie         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LIBC_H
+#define LIBC_H
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#define loop for (;;)
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+#ifndef MAX_LINE_SIZE
+#define MAX_LINE_SIZE 128
+#endif
+
+/* Rate used when UartOption.baud_rate is 0 or the UART is initialised lazily */
+#ifndef UART_DEFAULT_BAUD
+#define UART_DEFAULT_BAUD 115200UL
+#endif
+
+/* Largest accepted baud rate error in permille, 8N1 on both ends tolerates ~4.5% total */
+#ifndef UART_BAUD_TOLERANCE
+#define UART_BAUD_TOLERANCE 25
+#endif
+
+/* Capacity of the interrupt driven transmit queue, must be a power of two <= 256 */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 64
+#endif
+
+/* Capacity of the interrupt driven receive queue, must be a power of two <= 256 */
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 64
+#endif
+
+/*
+ * Number of line slots assembled by USART_RX_vect, one of them always being
+ * edited. Left at 0 the line queue and its RAM are compiled out.
+ */
+#ifndef UART_LINE_QUEUE_DEPTH
+#define UART_LINE_QUEUE_DEPTH 0
+#endif
+
+/* Capacity of one queued line including its terminator */
+#ifndef UART_LINE_SIZE
+#define UART_LINE_SIZE 32
+#endif
+
+/* What a writer does when the transmit queue is full */
+typedef enum {
+        UART_TX_BLOCK = 0, // wait for USART_UDRE_vect to make room
+        UART_TX_DROP  = 1  // discard the byte and count it in uart_tx_dropped()
+} UartTxPolicy;
+
+typedef struct {
+        uint32_t     baud_rate; // bits per second, 0 selects UART_DEFAULT_BAUD
+        bool         transmit;
+        bool         receive;
+        UartTxPolicy tx_policy;
+} UartOption;
+
+/* Receive error counters, saturating at 0xFFFF */
+typedef struct {
+        uint16_t overruns;     // DOR0: hardware FIFO overflowed before USART_RX_vect ran
+        uint16_t frame_errors; // FE0: bad stop bit, the byte is discarded
+        uint16_t overflows;    // receive or line queue was full, the byte or line is discarded
+} UartRxStats;
+
+/*
+ * Baud setting as programmed into the USART: UBRR0 in the low 12 bits and
+ * UART_BAUD_U2X when double speed mode is required. Normal mode is preferred
+ * when both reach the same error since it samples each bit more often.
+ */
+#define UART_BAUD_UBRR_MASK 0x0FFF
+#define UART_BAUD_U2X       0x8000
+#define UART_BAUD_INVALID   0xFFFF // rate out of UART_BAUD_TOLERANCE, only seen at run time
+
+void     uart_baud_unreachable(void) __attribute__((error("baud rate is not reachable within UART_BAUD_TOLERANCE at this F_CPU")));
+
+static inline __attribute__((always_inline)) uint16_t uart_baud_ubrr(uint32_t baud, uint8_t divisor) {
+        uint32_t ubrr = (F_CPU + baud * divisor / 2) / (baud * divisor);
+        if (ubrr) ubrr--;
+        return ubrr > UART_BAUD_UBRR_MASK ? UART_BAUD_UBRR_MASK : ubrr;
+}
+
+static inline __attribute__((always_inline)) uint16_t uart_baud_error(uint32_t baud, uint16_t ubrr, uint8_t divisor) {
+        uint32_t actual = F_CPU / ((uint32_t)divisor * (ubrr + 1));
+        uint32_t delta  = actual > baud ? actual - baud : baud - actual;
+        return delta >= baud ? 1000 : delta * 1000 / baud;
+}
+
+/* Folds to a constant when baud is one, and refuses to build if it is out of tolerance */
+static inline __attribute__((always_inline)) uint16_t uart_baud_setting(uint32_t baud) {
+        uint16_t normal       = uart_baud_ubrr(baud, 16);
+        uint16_t fast         = uart_baud_ubrr(baud, 8);
+        uint16_t normal_error = uart_baud_error(baud, normal, 16);
+        uint16_t fast_error   = uart_baud_error(baud, fast, 8);
+        uint16_t setting      = normal;
+        uint16_t error        = normal_error;
+
+        if (fast_error < normal_error) {
+                setting = fast | UART_BAUD_U2X;
+                error   = fast_error;
+        }
+        if (error > UART_BAUD_TOLERANCE) {
+                if (__builtin_constant_p(error)) uart_baud_unreachable();
+                return UART_BAUD_INVALID;
+        }
+        return setting;
+}
+
+uint16_t uart_baud_lookup(uint32_t baud); // UART_BAUD_INVALID when out of tolerance
+void     uart_configure(const UartOption *opts, uint16_t baud_setting);
+uint32_t uart_autobaud(void);
+
+/*
+ * Constant baud rates are resolved at compile time, anything else at run
+ * time. A run time rate out of UART_BAUD_TOLERANCE (a raw uart_autobaud()
+ * measurement, say) returns false and the UART runs at UART_DEFAULT_BAUD.
+ */
+static inline __attribute__((always_inline)) bool uart_init(UartOption *opts) {
+        uint32_t baud = (opts && opts->baud_rate) ? opts->baud_rate : UART_DEFAULT_BAUD;
+        if (__builtin_constant_p(baud)) {
+                uart_configure(opts, uart_baud_setting(baud));
+                return true;
+        }
+        uint16_t setting = uart_baud_lookup(baud);
+        if (setting == UART_BAUD_INVALID) {
+                uart_configure(opts, uart_baud_setting(UART_DEFAULT_BAUD));
+                return false;
+        }
+        uart_configure(opts, setting);
+        return true;
+}
+
+uint8_t  uart_getchar();
+int16_t  uart_try_getchar(void);
+uint8_t  uart_available(void);
+void     uart_rx_stats(UartRxStats *stats);
+void     uart_rx_stats_reset(void);
+#if UART_LINE_QUEUE_DEPTH > 0
+/*
+ * While line mode is on received bytes are edited into lines by the receive
+ * interrupt, backspace included, and echoed through the transmit queue.
+ * uart_take_line() copies out the oldest finished line without its newline
+ * and returns its length, or -1 when none is ready.
+ */
+void     uart_line_mode(bool enable, bool echo);
+bool     uart_line_ready(void);
+int16_t  uart_take_line(char *buff, size_t bufsize);
+#endif
+void     uart_putchar(uint8_t c);
+void     uart_flush(void);
+uint8_t  uart_tx_pending(void);
+uint16_t uart_tx_dropped(void);
+int16_t  uart_printf(const char *fmt, ...);
+int16_t  uart_printf_P(const char *fmt, ...);
+int16_t  uart_read(char *buff, size_t bufsize);
+int16_t  uart_read_until_delimiter(char *buff, size_t bufsize, uint8_t delimiter);
+int16_t  uart_write(const char *buff, size_t bufsize);
+int16_t  uart_write_until_delimiter(const char *buff, size_t bufsize, uint8_t delimiter);
+int16_t  uart_getline(char *buff, size_t bufsize);
+int16_t  uart_getline_echo(char *buff, size_t bufsize);
+int16_t  uart_putline(const char *buff);
+int16_t  uart_putline_P(const char *buff);
+
+/*
+ * Literal format strings and lines kept in flash instead of being copied to
+ * SRAM at startup. %S prints a string argument that also lives in flash.
+ */
+#define uart_printf_F(fmt, ...) uart_printf_P(PSTR(fmt), ##__VA_ARGS__)
+#define uart_putline_F(str)     uart_putline_P(PSTR(str))
+
+/*
+ * Formatting engine behind uart_printf, usable without the UART. Supports
+ * %c %s %S %d %i %u %x %X %b %p and %%, the '0' and '-' flags, a field width
+ * and the 'l' modifier for 32-bit integers. A precision on d, i and u prints
+ * a fixed point value without floats: "%.1d" of 253 is "25.3", of -5 "-0.5".
+ *
+ * fmt_buffer behaves like snprintf: it always NUL terminates when cap > 0 and
+ * returns the length the full output would have, so a result >= cap means
+ * the line was truncated. fmt_sink hands every byte to put(ctx, c).
+ */
+typedef void (*FmtPut)(void *ctx, char c);
+
+int16_t  fmt_buffer(char *dst, size_t cap, const char *fmt, ...);
+int16_t  fmt_buffer_P(char *dst, size_t cap, const char *fmt, ...);
+int16_t  fmt_sink(FmtPut put, void *ctx, const char *fmt, ...);
+int16_t  fmt_vsink(FmtPut put, void *ctx, const char *fmt, va_list args);
+
+#define fmt_buffer_F(dst, cap, fmt, ...) fmt_buffer_P(dst, cap, PSTR(fmt), ##__VA_ARGS__)
+
+/*
+ * Pre-parsed printing: PRINT("0x", HEX4(addr), " ", DEC(v)) expands at
+ * compile time into one typed emit call per argument, so there is no format
+ * string to scan and no varargs at run time. Strings print as is, char
+ * values as characters and every other integer in decimal. A character
+ * literal is an int in C, so PRINT("a", 'b') prints "a98": wrap literals in
+ * CHR(), as in PRINT("a", CHR('b')). Up to 16 arguments.
+ */
+typedef struct {
+        uint32_t value;
+        uint8_t  digits;
+} PrintHex;
+
+typedef struct {
+        const char *str;
+} PrintFlash;
+
+#define HEX2(v) ((PrintHex){.value = (uint8_t)(v), .digits = 2})
+#define HEX4(v) ((PrintHex){.value = (uint16_t)(v), .digits = 4})
+#define HEX8(v) ((PrintHex){.value = (uint32_t)(v), .digits = 8})
+#define DEC(v)  ((int32_t)(v))
+#define UDEC(v) ((uint32_t)(v))
+#define CHR(c)  ((char)(c))
+#define FSTR(s) ((PrintFlash){.str = PSTR(s)})
+
+void    uart_emit_str(const char *s);
+void    uart_emit_flash(PrintFlash s);
+void    uart_emit_char(char c);
+void    uart_emit_dec(int32_t v);
+void    uart_emit_udec(uint32_t v);
+void    uart_emit_hex(PrintHex v);
+
+#define uart_emit(x)                                                                                                                                           \
+        _Generic((x),                                                                                                                                          \
+            char *: uart_emit_str,                                                                                                                             \
+            const char *: uart_emit_str,                                                                                                                       \
+            char: uart_emit_char,                                                                                                                              \
+            signed char: uart_emit_dec,                                                                                                                        \
+            short: uart_emit_dec,                                                                                                                              \
+            int: uart_emit_dec,                                                                                                                                \
+            long: uart_emit_dec,                                                                                                                               \
+            unsigned char: uart_emit_udec,                                                                                                                     \
+            unsigned short: uart_emit_udec,                                                                                                                    \
+            unsigned int: uart_emit_udec,                                                                                                                      \
+            unsigned long: uart_emit_udec,                                                                                                                     \
+            PrintHex: uart_emit_hex,                                                                                                                           \
+            PrintFlash: uart_emit_flash)(x)
+
+#define PRINT_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, n, ...) n
+#define PRINT_COUNT(...)      PRINT_COUNT_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define PRINT_CONCAT_(a, b)   a##b
+#define PRINT_CONCAT(a, b)    PRINT_CONCAT_(a, b)
+#define PRINT_EACH_1(x)       uart_emit(x);
+#define PRINT_EACH_2(x, ...)  uart_emit(x); PRINT_EACH_1(__VA_ARGS__)
+#define PRINT_EACH_3(x, ...)  uart_emit(x); PRINT_EACH_2(__VA_ARGS__)
+#define PRINT_EACH_4(x, ...)  uart_emit(x); PRINT_EACH_3(__VA_ARGS__)
+#define PRINT_EACH_5(x, ...)  uart_emit(x); PRINT_EACH_4(__VA_ARGS__)
+#define PRINT_EACH_6(x, ...)  uart_emit(x); PRINT_EACH_5(__VA_ARGS__)
+#define PRINT_EACH_7(x, ...)  uart_emit(x); PRINT_EACH_6(__VA_ARGS__)
+#define PRINT_EACH_8(x, ...)  uart_emit(x); PRINT_EACH_7(__VA_ARGS__)
+#define PRINT_EACH_9(x, ...)  uart_emit(x); PRINT_EACH_8(__VA_ARGS__)
+#define PRINT_EACH_10(x, ...) uart_emit(x); PRINT_EACH_9(__VA_ARGS__)
+#define PRINT_EACH_11(x, ...) uart_emit(x); PRINT_EACH_10(__VA_ARGS__)
+#define PRINT_EACH_12(x, ...) uart_emit(x); PRINT_EACH_11(__VA_ARGS__)
+#define PRINT_EACH_13(x, ...) uart_emit(x); PRINT_EACH_12(__VA_ARGS__)
+#define PRINT_EACH_14(x, ...) uart_emit(x); PRINT_EACH_13(__VA_ARGS__)
+#define PRINT_EACH_15(x, ...) uart_emit(x); PRINT_EACH_14(__VA_ARGS__)
+#define PRINT_EACH_16(x, ...) uart_emit(x); PRINT_EACH_15(__VA_ARGS__)
+
+#define PRINT(...)                                                                                                                                             \
+        do {                                                                                                                                                   \
+                PRINT_CONCAT(PRINT_EACH_, PRINT_COUNT(__VA_ARGS__))(__VA_ARGS__)                                                                               \
+        } while (0)
+#define PRINTLN(...) PRINT(__VA_ARGS__, FSTR("\r\n"))
+
+/*
+ * Binary telemetry frames: type, sequence number, payload and a little endian
+ * CRC-16/MCRF4XX (the avr-libc _crc_ccitt_update) over everything before it,
+ * COBS encoded and closed by a 0x00 delimiter. The sequence number wraps and
+ * lets the receiver count lost frames. Frames are built one at a time from
+ * the main loop, never from an interrupt.
+ */
+#ifndef UART_FRAME_PAYLOAD_MAX
+#define UART_FRAME_PAYLOAD_MAX 32
+#endif
+
+#define UART_FRAME_HEADER_SIZE 2
+
+void    uart_frame_begin(uint8_t type);
+int16_t uart_frame_write(const void *data, uint8_t len);
+void    uart_frame_end(void);
+int16_t uart_frame_send(uint8_t type, const void *payload, uint8_t len);
+
+#define uart_assert(reg, value)                                                                                                                                \
+        do {                                                                                                                                                   \
+                if ((reg) != (value)) {                                                                                                                        \
+                        uart_printf_F("Assertion failed: %S != %S (got: 0x%X, expected: 0x%X)\r\n",                                                            \
+                                      PSTR(#reg), PSTR(#value), (unsigned int)(reg), (unsigned int)(value));                                                   \
+                        while (1) {                                                                                                                            \
+                        } /* Halt execution on assertion failure */                                                                                            \
+                }                                                                                                                                              \
+        } while (0)
+
+
+/* Failure codes of the parse_* family, every other return is a length */
+typedef enum {
+        PARSE_NO_DIGITS = -1, // no digit of the base after blanks, sign and prefix
+        PARSE_OVERFLOW  = -2  // digits do not fit the result type, nothing is stored
+} ParseError;
+
+/*
+ * Parse one number after optional blanks (and a sign for the signed
+ * variants), stopping at the first byte that is not a digit. Base 16 accepts
+ * a 0x prefix, base 2 a 0b prefix and base 0 picks 16, 2 or 10 from it.
+ * Returns how many bytes were consumed, so the rest of a command line can be
+ * parsed from str + result, or a ParseError with *value untouched.
+ */
+int16_t  parse_u8(const char *str, uint8_t base, uint8_t *value);
+int16_t  parse_u16(const char *str, uint8_t base, uint16_t *value);
+int16_t  parse_u32(const char *str, uint8_t base, uint32_t *value);
+int16_t  parse_i8(const char *str, uint8_t base, int8_t *value);
+int16_t  parse_i16(const char *str, uint8_t base, int16_t *value);
+int16_t  parse_i32(const char *str, uint8_t base, int32_t *value);
+
+/* Value only, 0 when nothing could be parsed or it overflowed */
+int16_t  parse_number(const char *number, uint8_t base);
+uint16_t parse_unsigned(const char *number, uint8_t base);
+
+/*
+ * Character classes as one flag byte per value kept in flash, so every
+ * classifier is a single LPM and an AND. Bytes above 0x7F have no class.
+ */
+#define CHAR_CLASS_SPACE  0x01 // \t \n \v \f \r and space
+#define CHAR_CLASS_UPPER  0x02
+#define CHAR_CLASS_LOWER  0x04
+#define CHAR_CLASS_DIGIT  0x08
+#define CHAR_CLASS_XALPHA 0x10 // A-F and a-f
+#define CHAR_CLASS_PUNCT  0x20
+#define CHAR_CLASS_CNTRL  0x40
+#define CHAR_CLASS_PRINT  0x80
+
+extern const uint8_t char_class_table[256] PROGMEM;
+
+static inline bool char_is(uint8_t c, uint8_t classes) {
+        return pgm_read_byte(&char_class_table[c]) & classes;
+}
+
+static inline bool is_whitespace(uint8_t c) {
+        return char_is(c, CHAR_CLASS_SPACE);
+}
+static inline bool is_alphabetic(uint8_t c) {
+        return char_is(c, CHAR_CLASS_UPPER | CHAR_CLASS_LOWER);
+}
+static inline bool is_digit(uint8_t c) {
+        return char_is(c, CHAR_CLASS_DIGIT);
+}
+static inline bool is_alphanumeric(uint8_t c) {
+        return char_is(c, CHAR_CLASS_UPPER | CHAR_CLASS_LOWER | CHAR_CLASS_DIGIT);
+}
+static inline bool is_punctuation(uint8_t c) {
+        return char_is(c, CHAR_CLASS_PUNCT);
+}
+static inline bool is_xdigit(uint8_t c) {
+        return char_is(c, CHAR_CLASS_DIGIT | CHAR_CLASS_XALPHA);
+}
+static inline bool is_cntrl(uint8_t c) {
+        return char_is(c, CHAR_CLASS_CNTRL);
+}
+static inline bool is_upper(uint8_t c) {
+        return char_is(c, CHAR_CLASS_UPPER);
+}
+static inline bool is_lower(uint8_t c) {
+        return char_is(c, CHAR_CLASS_LOWER);
+}
+static inline bool is_print(uint8_t c) {
+        return char_is(c, CHAR_CLASS_PRINT);
+}
+
+int16_t  string_count(const char *str, char ch);
+int16_t  string_ends_with(const char *str, const char *suffix);
+int16_t  string_starts_with(const char *str, const char *prefix);
+int16_t  string_case_compare(const char *s1, const char *s2);
+int16_t  string_compare(const char *s1, const char *s2);
+int16_t  string_reverse(char *str);
+int16_t  string_copy(char *dest, const char *src);
+int16_t  string_concat(char *dest, const char *src);
+int16_t  string_contains(const char *str, const char *substr);
+char *   string_search_byte(const char *str, char c);
+char *   string_search_substring(const char *str, const char *substr);
+int16_t  string_last_index_of_none(const char *str, const char *set);
+int16_t  string_first_index_of_none(const char *str, const char *set);
+int16_t  string_last_index_of(const char *str, char c);
+int16_t  string_first_index_of(const char *str, char c);
+int16_t  string_spn(const char *s, const char *accept);
+int16_t  string_cspn(const char *s, const char *reject);
+int16_t  string_length(const char *s);
+char *   string_tokenize(char *str, const char *delim);
+
+/*
+ * Horspool substring search. The bad character table is folded to
+ * SEARCH_SHIFT_SIZE buckets to save RAM, colliding bytes share the smaller
+ * shift. Prepare a needle of up to 255 bytes once with search_pattern_init()
+ * to search many haystacks without rebuilding the table. Haystacks are
+ * length bounded, need no terminator and index up to 32767 bytes; longer
+ * ones return -1. string_search_substring() and string_contains() fall back
+ * to a byte scan for needles or haystacks these limits leave out.
+ */
+#define SEARCH_SHIFT_SIZE 32
+
+typedef struct {
+        const char *needle;
+        uint8_t     len;
+        uint8_t     shift[SEARCH_SHIFT_SIZE];
+} SearchPattern;
+
+int16_t  search_pattern_init(SearchPattern *pat, const char *needle);
+int16_t  search_pattern_find(const SearchPattern *pat, const char *hay, uint16_t hay_len);
+int16_t  string_search_bounded(const char *hay, uint16_t hay_len, const char *needle);
+
+/*
+ * 256 bit membership map, one bit per byte value. Built once with
+ * charset_init() or at compile time with CHARSET("literal"), a set of up to
+ * CHARSET_LITERAL_MAX characters usable as a static initializer:
+ *
+ *   static const CharSet delimiters = CHARSET(" \t,");
+ */
+typedef struct {
+        uint8_t bits[32];
+} CharSet;
+
+#define CHARSET_LITERAL_MAX 16
+#define CHARSET_AT_(s, k)     ((uint8_t)(s)[(k) < sizeof(s) ? (k) : sizeof(s) - 1])
+#define CHARSET_BIT_(s, k, i) ((CHARSET_AT_(s, k) && (CHARSET_AT_(s, k) >> 3) == (i)) ? (1 << (CHARSET_AT_(s, k) & 7)) : 0)
+#define CHARSET_BYTE_(s, i)                                                                                                                                    \
+        ((uint8_t)(CHARSET_BIT_(s, 0, i) | CHARSET_BIT_(s, 1, i) | CHARSET_BIT_(s, 2, i) | CHARSET_BIT_(s, 3, i) |                                             \
+                   CHARSET_BIT_(s, 4, i) | CHARSET_BIT_(s, 5, i) | CHARSET_BIT_(s, 6, i) | CHARSET_BIT_(s, 7, i) |                                             \
+                   CHARSET_BIT_(s, 8, i) | CHARSET_BIT_(s, 9, i) | CHARSET_BIT_(s, 10, i) | CHARSET_BIT_(s, 11, i) |                                           \
+                   CHARSET_BIT_(s, 12, i) | CHARSET_BIT_(s, 13, i) | CHARSET_BIT_(s, 14, i) | CHARSET_BIT_(s, 15, i)))
+#define CHARSET(s)                                                                                                                                             \
+        {{CHARSET_BYTE_(s, 0) + 0 * sizeof(char[sizeof(s) <= CHARSET_LITERAL_MAX + 1 ? 1 : -1]),                                                               \
+          CHARSET_BYTE_(s, 1), CHARSET_BYTE_(s, 2), CHARSET_BYTE_(s, 3),                                                                                       \
+          CHARSET_BYTE_(s, 4), CHARSET_BYTE_(s, 5), CHARSET_BYTE_(s, 6), CHARSET_BYTE_(s, 7),                                                                  \
+          CHARSET_BYTE_(s, 8), CHARSET_BYTE_(s, 9), CHARSET_BYTE_(s, 10), CHARSET_BYTE_(s, 11),                                                                \
+          CHARSET_BYTE_(s, 12), CHARSET_BYTE_(s, 13), CHARSET_BYTE_(s, 14), CHARSET_BYTE_(s, 15),                                                              \
+          CHARSET_BYTE_(s, 16), CHARSET_BYTE_(s, 17), CHARSET_BYTE_(s, 18), CHARSET_BYTE_(s, 19),                                                              \
+          CHARSET_BYTE_(s, 20), CHARSET_BYTE_(s, 21), CHARSET_BYTE_(s, 22), CHARSET_BYTE_(s, 23),                                                              \
+          CHARSET_BYTE_(s, 24), CHARSET_BYTE_(s, 25), CHARSET_BYTE_(s, 26), CHARSET_BYTE_(s, 27),                                                              \
+          CHARSET_BYTE_(s, 28), CHARSET_BYTE_(s, 29), CHARSET_BYTE_(s, 30), CHARSET_BYTE_(s, 31)}}
+
+static inline bool charset_has(const CharSet *set, uint8_t c) {
+        return set->bits[c >> 3] & (1 << (c & 7));
+}
+
+void     charset_init(CharSet *set, const char *chars);
+void     charset_add(CharSet *set, uint8_t c);
+int16_t  string_spn_set(const char *s, const CharSet *accept);
+int16_t  string_cspn_set(const char *s, const CharSet *reject);
+int16_t  string_first_index_of_none_set(const char *str, const CharSet *set);
+int16_t  string_last_index_of_none_set(const char *str, const CharSet *set);
+char *   string_tokenize_set(char *str, const CharSet *delim);
+
+/*
+ * Read-only view into a string that is neither copied nor NUL terminated.
+ * Span operations never write to the text, so one received line can be
+ * split, trimmed and parsed in place; token state lives in the caller's
+ * Span, which makes span_next_token() reentrant.
+ */
+typedef struct {
+        const char *p;
+        uint8_t     len;
+} Span;
+
+static inline Span span_make(const char *p, uint8_t len) {
+        return (Span){.p = p, .len = len};
+}
+
+/* Sub view starting at start of at most len bytes, clamped to s */
+static inline Span span_slice(Span s, uint8_t start, uint8_t len) {
+        if (start > s.len) start = s.len;
+        if (len > s.len - start) len = s.len - start;
+        return span_make(s.p + start, len);
+}
+
+#define span_equals_F(s, str)      span_equals_P(s, PSTR(str))
+#define span_case_equals_F(s, str) span_case_equals_P(s, PSTR(str))
+
+Span     span_from(const char *str);
+Span     span_trim(Span s);
+Span     span_split(Span *rest, char delim);
+bool     span_next_token(Span *rest, const CharSet *delim, Span *token);
+int16_t  span_compare(Span a, Span b);
+int16_t  span_case_compare(Span a, Span b);
+bool     span_equals_P(Span s, const char *str);
+bool     span_case_equals_P(Span s, const char *str);
+int16_t  span_parse_unsigned(Span s, uint8_t base, uint32_t *value);
+int16_t  span_parse_signed(Span s, uint8_t base, int32_t *value);
+int16_t  span_copy(Span s, char *dst, size_t dstsize);
+
+/*
+ * Bounded string builder. The length is tracked, so every append costs only
+ * the bytes it adds, unlike string_concat which rescans dest each call. The
+ * buffer is always NUL terminated; whatever does not fit is cut off, sets
+ * overflow and makes the append return false. Assemble a line, then send it
+ * with one string_builder_send().
+ */
+typedef struct {
+        char   *buf;
+        uint8_t cap; // size of buf including the terminating NUL
+        uint8_t len;
+        bool    overflow;
+} StringBuilder;
+
+void     string_builder_init(StringBuilder *sb, char *buf, uint8_t cap);
+void     string_builder_reset(StringBuilder *sb);
+bool     string_builder_append_char(StringBuilder *sb, char c);
+bool     string_builder_append_str(StringBuilder *sb, const char *s);
+bool     string_builder_append_str_P(StringBuilder *sb, const char *s);
+bool     string_builder_append_span(StringBuilder *sb, Span s);
+bool     string_builder_append_uint(StringBuilder *sb, uint32_t value);
+bool     string_builder_append_int(StringBuilder *sb, int32_t value);
+bool     string_builder_append_hex(StringBuilder *sb, uint32_t value, uint8_t digits);
+int16_t  string_builder_send(const StringBuilder *sb);
+
+#define string_builder_append_F(sb, str) string_builder_append_str_P(sb, PSTR(str))
+
+/*
+ * Serial command tables kept in flash. command_set_init() hashes every name
+ * once (first byte, last byte and length) into a small slot index in RAM, so
+ * dispatch compares against a single entry however many commands there are.
+ * Two names sharing a slot make init fail: rename one or raise COMMAND_SLOTS.
+ *
+ *   static const Command cli[] PROGMEM = {
+ *       {"READ", "<key>", 1, read_handler},
+ *   };
+ *
+ * Names match case-insensitively. The handler gets exactly argc arguments;
+ * any other count prints "Usage: NAME HELP" instead of calling it.
+ */
+#ifndef COMMAND_NAME_SIZE
+#define COMMAND_NAME_SIZE 16
+#endif
+
+#ifndef COMMAND_HELP_SIZE
+#define COMMAND_HELP_SIZE 24
+#endif
+
+#ifndef COMMAND_ARGS_MAX
+#define COMMAND_ARGS_MAX 4
+#endif
+
+#ifndef COMMAND_SLOTS
+#define COMMAND_SLOTS 16
+#endif
+
+#if COMMAND_SLOTS < 1 || COMMAND_SLOTS > 128 || (COMMAND_SLOTS & (COMMAND_SLOTS - 1))
+#error "COMMAND_SLOTS must be a power of two between 1 and 128"
+#endif
+
+typedef void (*CommandHandler)(const Span *args, uint8_t argc);
+
+typedef struct {
+        char           name[COMMAND_NAME_SIZE];
+        char           help[COMMAND_HELP_SIZE]; // argument synopsis, shown by usage errors and command_help()
+        uint8_t        argc;
+        CommandHandler handler;
+} Command;
+
+typedef struct {
+        const Command *table; // in flash
+        uint8_t        count;
+        uint8_t        slots[COMMAND_SLOTS]; // table index per hash slot, 0xFF when free
+} CommandSet;
+
+/* Failure codes of command_dispatch(), 0 means a handler ran */
+typedef enum {
+        COMMAND_EMPTY   = -1, // nothing but delimiters on the line
+        COMMAND_UNKNOWN = -2, // no entry with that name, nothing printed
+        COMMAND_USAGE   = -3  // wrong argument count, usage printed
+} CommandError;
+
+#define COMMAND_COUNT(table) ((uint8_t)(sizeof(table) / sizeof((table)[0])))
+
+int16_t  command_set_init(CommandSet *set, const Command *table, uint8_t count);
+int16_t  command_dispatch(const CommandSet *set, Span line, const CharSet *delim);
+void     command_help(const CommandSet *set);
+
+
+/* Bytes kept for recalling previous lines with the up/down arrows, 0 disables history */
+#ifndef LINE_HISTORY_SIZE
+#define LINE_HISTORY_SIZE 64
+#endif
+
+/*
+ * In-place line editor for a VT100 terminal. Feed it with line_editor_poll()
+ * from the main loop: it only consumes bytes already in the receive queue and
+ * returns -1 until Enter is pressed, then the line length. The text is edited
+ * directly in buf and stays there, NUL terminated, until the next keystroke.
+ *
+ * Keys: printable characters insert at the cursor, backspace/delete, left and
+ * right arrows, Home/End (also Ctrl-A/Ctrl-E), up/down arrows for history.
+ */
+typedef struct {
+        char   *buf;
+        uint8_t cap;     // size of buf including the terminating NUL
+        uint8_t len;
+        uint8_t cursor;
+        uint8_t esc;     // escape sequence parser state
+        uint8_t esc_arg; // numeric parameter of "ESC [ n ~"
+        uint8_t recall;  // history entry shown, 0 is the line being typed
+        bool    skip_lf; // swallow the '\n' of a "\r\n" pair
+} LineEditor;
+
+void     line_editor_init(LineEditor *ed, char *buf, uint8_t cap);
+int16_t  line_editor_poll(LineEditor *ed);
+int16_t  line_editor_feed(LineEditor *ed, char c);
+
+int16_t  readline_echo_back(char *buffer, size_t busize);
+int16_t  clear_line(uint16_t count);
+
+
+#endif // LIBC_H
@@ -0,0 +1,101 @@
+#ifndef PIN_H
+#define PIN_H
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Compile-time pins, for when the pin is known at build time. A pin is the
+ * pair "port letter, bit", so it can be named once:
+ *
+ *   #define LED_D1 B, PB0
+ *   pin_output(LED_D1);
+ *   pin_toggle(LED_D1);
+ *
+ * Register and mask are constants, so each call folds to a single sbi, cbi
+ * or sbis/sbic instead of the pointer loads and shift loop of a GpioPin.
+ * pin_toggle writes the bit to PINx, which flips the output in hardware
+ * without reading PORTx first.
+ */
+#define pin_output(...)              pin_output_(__VA_ARGS__)
+#define pin_input(...)               pin_input_(__VA_ARGS__)
+#define pin_pullup(...)              pin_pullup_(__VA_ARGS__)
+#define pin_set(...)                 pin_set_(__VA_ARGS__)
+#define pin_clear(...)               pin_clear_(__VA_ARGS__)
+#define pin_toggle(...)              pin_toggle_(__VA_ARGS__)
+#define pin_read(...)                pin_read_(__VA_ARGS__)
+#define pin_write(...)               pin_write_(__VA_ARGS__)
+
+#define pin_mask_(bit)               ((uint8_t)(1U << (bit)))
+#define pin_output_(port, bit)       (DDR##port |= pin_mask_(bit))
+#define pin_input_(port, bit)        (DDR##port &= (uint8_t)~pin_mask_(bit))
+#define pin_pullup_(port, bit)                                                                                                                                 \
+        do {                                                                                                                                                   \
+                pin_input_(port, bit);                                                                                                                         \
+                pin_set_(port, bit);                                                                                                                           \
+        } while (0)
+#define pin_set_(port, bit)          (PORT##port |= pin_mask_(bit))
+#define pin_clear_(port, bit)        (PORT##port &= (uint8_t)~pin_mask_(bit))
+#define pin_toggle_(port, bit)       (PIN##port = pin_mask_(bit))
+#define pin_read_(port, bit)         ((PIN##port & pin_mask_(bit)) != 0)
+#define pin_write_(port, bit, level) ((level) ? pin_set_(port, bit) : pin_clear_(port, bit))
+
+/*
+ * Pin groups: up to four logical bits spread over any pins of one port,
+ * e.g. the LED bar PIN_GROUP(B, PB0, PB1, PB2, PB4). The table built at
+ * compile time gives the port bits for every 4-bit value, so a write is one
+ * lookup and a single store of the port, with interrupts held off around
+ * the read-modify-write so an ISR touching other pins of the port is not
+ * undone. Unused slots take PIN_NONE; wider values use one group per nibble.
+ * Groups are read with pgm_read_*, declare them PROGMEM:
+ *
+ *   static const PinGroup led_bar PROGMEM = PIN_GROUP(B, PB0, PB1, PB2, PB4);
+ */
+#define PIN_NONE 8
+
+typedef struct {
+        uint16_t port;    // data space addresses of PORTx and DDRx
+        uint16_t ddr;
+        uint8_t  mask;    // every pin of the group
+        uint8_t  lut[16]; // port bits for each logical value
+} PinGroup;
+
+#define pin_group_bit_(bit)                 ((bit) < 8 ? pin_mask_(bit) : 0)
+#define pin_group_entry_(v, b0, b1, b2, b3)                                                                                                                    \
+        (((v) & 1 ? pin_group_bit_(b0) : 0) | ((v) & 2 ? pin_group_bit_(b1) : 0) | ((v) & 4 ? pin_group_bit_(b2) : 0) | ((v) & 8 ? pin_group_bit_(b3) : 0))
+#define PIN_GROUP(port_, b0, b1, b2, b3)                                                                                                                       \
+        {                                                                                                                                                      \
+                .port = _SFR_MEM_ADDR(PORT##port_),                                                                                                            \
+                .ddr  = _SFR_MEM_ADDR(DDR##port_),                                                                                                             \
+                .mask = pin_group_entry_(15, b0, b1, b2, b3),                                                                                                  \
+                .lut  = {                                                                                                                                      \
+                    pin_group_entry_(0, b0, b1, b2, b3),  pin_group_entry_(1, b0, b1, b2, b3),  pin_group_entry_(2, b0, b1, b2, b3),                          \
+                    pin_group_entry_(3, b0, b1, b2, b3),  pin_group_entry_(4, b0, b1, b2, b3),  pin_group_entry_(5, b0, b1, b2, b3),                          \
+                    pin_group_entry_(6, b0, b1, b2, b3),  pin_group_entry_(7, b0, b1, b2, b3),  pin_group_entry_(8, b0, b1, b2, b3),                          \
+                    pin_group_entry_(9, b0, b1, b2, b3),  pin_group_entry_(10, b0, b1, b2, b3), pin_group_entry_(11, b0, b1, b2, b3),                         \
+                    pin_group_entry_(12, b0, b1, b2, b3), pin_group_entry_(13, b0, b1, b2, b3), pin_group_entry_(14, b0, b1, b2, b3),                         \
+                    pin_group_entry_(15, b0, b1, b2, b3),                                                                                                      \
+                },                                                                                                                                             \
+        }
+
+static inline void pin_group_output(const PinGroup *group) {
+        volatile uint8_t *ddr  = (volatile uint8_t *)pgm_read_word(&group->ddr);
+        uint8_t           mask = pgm_read_byte(&group->mask);
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                *ddr |= mask;
+        }
+}
+
+static inline void pin_group_write(const PinGroup *group, uint8_t value) {
+        volatile uint8_t *port = (volatile uint8_t *)pgm_read_word(&group->port);
+        uint8_t           mask = pgm_read_byte(&group->mask);
+        uint8_t           bits = pgm_read_byte(&group->lut[value & 0x0F]);
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                *port = (*port & ~mask) | bits;
+        }
+}
+
+#endif // PIN_H
@@ -0,0 +1,109 @@
+#include "scheduler.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+
+typedef struct {
+        TaskFn   fn;
+        void    *ctx;
+        uint16_t period;   // ms, 0 for tasks that only run when posted
+        uint16_t deadline; // ms after the release
+        uint16_t missed;
+        uint16_t overruns;
+        uint32_t due;
+        uint32_t released;
+} Task;
+
+static Task             scheduler_tasks[SCHEDULER_TASKS];
+static volatile uint8_t scheduler_ready;
+
+/* 0 on success, -1 if the priority is out of range or already taken */
+int16_t scheduler_add(uint8_t priority, TaskFn fn, void *ctx, uint16_t period, uint16_t deadline) {
+        if (priority >= SCHEDULER_TASKS || !fn || scheduler_tasks[priority].fn) return -1;
+        Task *task   = &scheduler_tasks[priority];
+        task->ctx      = ctx;
+        task->period   = period;
+        task->deadline = deadline ? deadline : period;
+        task->missed   = 0;
+        task->overruns = 0;
+        task->due      = millis();
+        task->fn       = fn;
+        return 0;
+}
+
+void scheduler_remove(uint8_t priority) {
+        if (priority >= SCHEDULER_TASKS) return;
+        scheduler_tasks[priority].fn = 0;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                scheduler_ready &= ~(1 << priority);
+        }
+}
+
+/* Safe from ISRs, the task runs once from the main loop however often it is posted */
+void scheduler_post(uint8_t priority) {
+        if (priority >= SCHEDULER_TASKS) return;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                scheduler_ready |= 1 << priority;
+        }
+}
+
+static void scheduler_release_due(void) {
+        uint32_t now = millis();
+        for (uint8_t i = 0; i < SCHEDULER_TASKS; i++) {
+                Task *task = &scheduler_tasks[i];
+                if (!task->fn || !task->period || (int32_t)(now - task->due) < 0) continue;
+                if (scheduler_ready & (1 << i)) task->missed++;
+                scheduler_post(i);
+                task->released = task->due;
+                /* next release keeps the phase, periods lost in a long stall are dropped */
+                task->due += task->period;
+                if ((int32_t)(now - task->due) >= 0) task->due = now + task->period;
+        }
+}
+
+/* Runs the most urgent ready task, false when there was none */
+bool scheduler_step(void) {
+        scheduler_release_due();
+        uint8_t ready = scheduler_ready;
+        for (uint8_t i = 0; i < SCHEDULER_TASKS; i++) {
+                uint8_t bit = 1 << i;
+                if (!(ready & bit)) continue;
+                ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+                        scheduler_ready &= ~bit;
+                }
+                Task *task = &scheduler_tasks[i];
+                if (!task->fn) return true;
+                task->fn(task->ctx);
+                if (task->period && millis() - task->released > task->deadline) task->overruns++;
+                return true;
+        }
+        return false;
+}
+
+/*
+ * Idles the CPU between tasks. Interrupts are only enabled by the sei right
+ * before sleep, which executes the next instruction first, so a post that
+ * lands after the check still wakes us; the clock tick wakes us every ms.
+ */
+void scheduler_run(void) {
+        set_sleep_mode(SLEEP_MODE_IDLE);
+        for (;;) {
+                if (scheduler_step()) continue;
+                cli();
+                if (!scheduler_ready) {
+                        sleep_enable();
+                        sei();
+                        sleep_cpu();
+                        sleep_disable();
+                }
+                sei();
+        }
+}
+
+uint16_t scheduler_missed(uint8_t priority) {
+        return priority < SCHEDULER_TASKS ? scheduler_tasks[priority].missed : 0;
+}
+
+uint16_t scheduler_overruns(uint8_t priority) {
+        return priority < SCHEDULER_TASKS ? scheduler_tasks[priority].overruns : 0;
+}
@@ -0,0 +1,47 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "clock.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Cooperative run-to-completion scheduler. Each task owns one priority,
+ * 0 being the most urgent, which is also its bit in the ready bitmap. A
+ * task becomes ready when its period comes due on the millisecond clock
+ * (call clock_init() first) or when scheduler_post() is called, typically
+ * from an ISR that hands the real work to the main loop. The highest
+ * priority ready task runs to the end, then the choice is made again, so a
+ * slow low priority task delays others by at most its own run time.
+ *
+ *   scheduler_add(0, refresh_display, NULL, 4, 2);
+ *   scheduler_add(1, sample_sensor, NULL, 20, 0);
+ *   scheduler_add(2, handle_uart, NULL, 0, 0); // only runs when posted
+ *   scheduler_run();
+ *
+ * A periodic task still waiting when its next period comes due runs once,
+ * and the miss is counted in scheduler_missed(). Periodic tasks also have a
+ * relative deadline in ms, 0 meaning the period: a run that ends later than
+ * that after its release is counted in scheduler_overruns(). There is no
+ * preemption, so a deadline is only checked, never enforced; keep tasks
+ * short enough that the most urgent one fits. Posted tasks have no deadline.
+ */
+#ifndef SCHEDULER_TASKS
+#define SCHEDULER_TASKS 8
+#endif
+
+#if SCHEDULER_TASKS < 1 || SCHEDULER_TASKS > 8
+#error "SCHEDULER_TASKS must be between 1 and 8, one bit of the ready bitmap each"
+#endif
+
+typedef void (*TaskFn)(void *ctx);
+
+int16_t  scheduler_add(uint8_t priority, TaskFn fn, void *ctx, uint16_t period, uint16_t deadline);
+void     scheduler_remove(uint8_t priority);
+void     scheduler_post(uint8_t priority);
+bool     scheduler_step(void);
+void     scheduler_run(void) __attribute__((noreturn));
+uint16_t scheduler_missed(uint8_t priority);
+uint16_t scheduler_overruns(uint8_t priority);
+
+#endif // SCHEDULER_H
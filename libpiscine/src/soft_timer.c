@@ -0,0 +1,69 @@
+#include "soft_timer.h"
+
+#define SOFT_TIMER_MASK (SOFT_TIMER_WHEEL_SIZE - 1)
+
+static SoftTimer *soft_timer_wheel[SOFT_TIMER_WHEEL_SIZE];
+static uint32_t   soft_timer_now; // last tick whose slot was processed
+
+static void soft_timer_insert(SoftTimer *timer) {
+        SoftTimer **head = &soft_timer_wheel[timer->due & SOFT_TIMER_MASK];
+        timer->next      = *head;
+        if (timer->next) timer->next->link = &timer->next;
+        timer->link = head;
+        *head       = timer;
+}
+
+void soft_timer_stop(SoftTimer *timer) {
+        if (!timer || !timer->link) return;
+        *timer->link = timer->next;
+        if (timer->next) timer->next->link = timer->link;
+        timer->next = 0;
+        timer->link = 0;
+}
+
+/* Restarts the timer if it was already running, delay 0 fires on the next poll */
+void soft_timer_start(SoftTimer *timer, uint32_t delay, uint32_t period, SoftTimerCallback callback, void *ctx) {
+        if (!timer || !callback) return;
+        soft_timer_stop(timer);
+        timer->due      = millis() + delay;
+        timer->period   = period;
+        timer->callback = callback;
+        timer->ctx      = ctx;
+        /* slots up to soft_timer_now are done, an earlier due would wait a full wheel turn */
+        if ((int32_t)(timer->due - soft_timer_now) <= 0) timer->due = soft_timer_now + 1;
+        soft_timer_insert(timer);
+}
+
+/* Fires the first due timer of the slot, false when none is left */
+static bool soft_timer_fire_one(SoftTimer **slot, uint32_t now) {
+        for (SoftTimer *timer = *slot; timer; timer = timer->next) {
+                if ((int32_t)(timer->due - now) > 0) continue;
+                soft_timer_stop(timer);
+                if (timer->period) {
+                        /* keeps its phase, a period missed during a long stall is skipped */
+                        timer->due += timer->period;
+                        if ((int32_t)(timer->due - now) <= 0) timer->due = now + 1;
+                        soft_timer_insert(timer);
+                }
+                timer->callback(timer->ctx);
+                return true;
+        }
+        return false;
+}
+
+void soft_timer_poll(void) {
+        uint32_t now    = millis();
+        uint32_t behind = now - soft_timer_now;
+        if (!behind) return;
+
+        /* past one full turn every slot is visited once and due times do the rest */
+        uint8_t steps = behind < SOFT_TIMER_WHEEL_SIZE ? behind : SOFT_TIMER_WHEEL_SIZE;
+        uint8_t index = soft_timer_now;
+        soft_timer_now = now;
+        while (steps--) {
+                SoftTimer **slot = &soft_timer_wheel[++index & SOFT_TIMER_MASK];
+                /* rescanned after each callback, which may start or stop any timer */
+                while (soft_timer_fire_one(slot, now))
+                        ;
+        }
+}
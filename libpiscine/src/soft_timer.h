@@ -0,0 +1,50 @@
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+#include "clock.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Software timers on a hashed wheel driven by the millisecond clock, so any
+ * number of one-shot and periodic timers share Timer1 (call clock_init()
+ * first). A timer hangs in the slot of its due time modulo the wheel size;
+ * start and stop are O(1) list operations, and each clock tick only looks
+ * at one slot.
+ *
+ * Nothing runs in the ISR: soft_timer_poll(), called from the main loop,
+ * catches up with millis() and runs the callbacks that came due. Timers are
+ * started and stopped from the main loop or from callbacks, not from ISRs.
+ *
+ *   static SoftTimer blink;
+ *   soft_timer_start(&blink, 500, 500, toggle_led, NULL);
+ *   loop { soft_timer_poll(); }
+ */
+#ifndef SOFT_TIMER_WHEEL_SIZE
+#define SOFT_TIMER_WHEEL_SIZE 16
+#endif
+
+#if SOFT_TIMER_WHEEL_SIZE < 1 || SOFT_TIMER_WHEEL_SIZE > 128 || (SOFT_TIMER_WHEEL_SIZE & (SOFT_TIMER_WHEEL_SIZE - 1))
+#error "SOFT_TIMER_WHEEL_SIZE must be a power of two between 1 and 128"
+#endif
+
+typedef void (*SoftTimerCallback)(void *ctx);
+
+typedef struct SoftTimer {
+        struct SoftTimer  *next;
+        struct SoftTimer **link;   // pointer that points at this timer, NULL when stopped
+        uint32_t           due;    // millis() at which it fires
+        uint32_t           period; // 0 for a one-shot timer
+        SoftTimerCallback  callback;
+        void              *ctx;
+} SoftTimer;
+
+void soft_timer_start(SoftTimer *timer, uint32_t delay, uint32_t period, SoftTimerCallback callback, void *ctx);
+void soft_timer_stop(SoftTimer *timer);
+void soft_timer_poll(void);
+
+static inline bool soft_timer_active(const SoftTimer *timer) {
+        return timer->link != 0;
+}
+
+#endif // SOFT_TIMER_H
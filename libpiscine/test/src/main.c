@@ -0,0 +1,72 @@
+#include "libc.h"
+
+static uint16_t checks;
+static uint16_t failures;
+
+/* Prints the failing expression with its line, flash strings keep SRAM free */
+#define CHECK(expr)                                                                                                                                            \
+        do {                                                                                                                                                   \
+                checks++;                                                                                                                                      \
+                if (!(expr)) {                                                                                                                                 \
+                        failures++;                                                                                                                            \
+                        uart_printf_F("FAIL %u: %S\r\n", __LINE__, PSTR(#expr));                                                                               \
+                }                                                                                                                                              \
+        } while (0)
+
+#define SPAN(lit) span_make(lit, sizeof(lit) - 1)
+
+void test_span_parse(void) {
+        uint32_t u = 0;
+        int32_t  v = 0;
+
+        CHECK(span_parse_unsigned(SPAN("Ff"), 16, &u) == 2 && u == 0xFF);
+        CHECK(span_parse_unsigned(SPAN("0x1F"), 16, &u) == 4 && u == 0x1F);
+        CHECK(span_parse_unsigned(SPAN("255"), 10, &u) == 3 && u == 255);
+        CHECK(span_parse_signed(SPAN("-12"), 10, &v) == 3 && v == -12);
+        CHECK(span_parse_signed(SPAN("+7"), 10, &v) == 2 && v == 7);
+
+        /* the span is the number: nothing may come before or after it */
+        u = 42;
+        CHECK(span_parse_unsigned(SPAN(" F"), 16, &u) == -1 && u == 42);
+        CHECK(span_parse_unsigned(SPAN("\tF"), 16, &u) == -1 && u == 42);
+        CHECK(span_parse_unsigned(SPAN("F "), 16, &u) == -1 && u == 42);
+        CHECK(span_parse_unsigned(SPAN("G0"), 16, &u) == -1 && u == 42);
+        CHECK(span_parse_unsigned(SPAN("+5"), 10, &u) == -1 && u == 42);
+        CHECK(span_parse_unsigned(SPAN(""), 10, &u) == -1 && u == 42);
+        CHECK(span_parse_unsigned(SPAN("4294967296"), 10, &u) == -1 && u == 42);
+        v = 42;
+        CHECK(span_parse_signed(SPAN(" -1"), 10, &v) == -1 && v == 42);
+        CHECK(span_parse_signed(SPAN("-"), 10, &v) == -1 && v == 42);
+}
+
+/* Needles longer than a SearchPattern holds and haystacks past int16_t */
+void test_search_limits(void) {
+        static char hay[400];
+        char       *needle = hay + 99;
+
+        for (uint16_t i = 0; i < sizeof(hay) - 1; i++) hay[i] = i < 99 ? 'b' : 'a' + i % 7;
+        hay[sizeof(hay) - 1] = '\0';
+
+        SearchPattern pat;
+        CHECK(search_pattern_init(&pat, needle) == -1);
+        CHECK(string_search_substring(hay, needle) == needle);
+        CHECK(string_contains(hay, needle) == 99);
+        CHECK(string_contains(hay + 100, needle) == -1);
+
+        CHECK(search_pattern_init(&pat, "ab") == 0);
+        CHECK(search_pattern_find(&pat, "xxab", 4) == 2);
+        CHECK(search_pattern_find(&pat, "xxab", 40000) == -1); // rejected before hay is read
+}
+
+int main(void) {
+        UartOption opts = {.baud_rate = 115200, .transmit = true, .receive = false};
+        uart_init(&opts);
+
+        test_span_parse();
+        test_search_limits();
+
+        uart_printf_F("%u checks, %u failed\r\n", checks, failures);
+        uart_flush();
+        loop {
+        }
+}
@@ -0,0 +1,198 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*
+ * Reads COBS frames produced by uart_frame_*() from a serial port, or from
+ * stdin when no port is given, and prints one line per valid frame:
+ *
+ *   seq type len: payload bytes in hex
+ *
+ * Frames failing their CRC and gaps in the sequence numbers are reported on
+ * stderr with a running total printed on exit.
+ */
+
+#define FRAME_HEADER_SIZE 2
+#define FRAME_CRC_SIZE    2
+#define FRAME_MAX         254
+
+typedef struct {
+        unsigned long frames;
+        unsigned long crc_errors;
+        unsigned long lost;
+        bool          synced;
+        uint8_t       next_seq;
+} Stats;
+
+static volatile bool running = true;
+
+/* Same as avr-libc _crc_ccitt_update(), CRC-16/MCRF4XX when seeded with 0xFFFF */
+static uint16_t      crc_ccitt_update(uint16_t crc, uint8_t data) {
+        data ^= (uint8_t)crc;
+        data ^= data << 4;
+        return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+}
+
+/* Decodes one COBS frame without its delimiter, returns the decoded length or -1 */
+static int cobs_decode(const uint8_t *in, size_t len, uint8_t *out) {
+        size_t i = 0;
+        size_t o = 0;
+        while (i < len) {
+                uint8_t code = in[i++];
+                if (!code || i + code - 1 > len) return -1;
+                for (uint8_t k = 1; k < code; k++) {
+                        out[o++] = in[i++];
+                }
+                if (code != 0xFF && i < len) out[o++] = 0;
+        }
+        return (int)o;
+}
+
+static speed_t baud_to_speed(long baud) {
+        switch (baud) {
+                case 9600: return B9600;
+                case 19200: return B19200;
+                case 38400: return B38400;
+                case 57600: return B57600;
+                case 115200: return B115200;
+                case 230400: return B230400;
+                case 500000: return B500000;
+                case 1000000: return B1000000;
+                case 2000000: return B2000000;
+                default: return 0;
+        }
+}
+
+static int open_port(const char *path, long baud) {
+        speed_t speed = baud_to_speed(baud);
+        if (!speed) {
+                fprintf(stderr, "unsupported baud rate %ld\n", baud);
+                return -1;
+        }
+        int fd = open(path, O_RDONLY | O_NOCTTY);
+        if (fd < 0) {
+                fprintf(stderr, "%s: %s\n", path, strerror(errno));
+                return -1;
+        }
+        struct termios tio;
+        if (tcgetattr(fd, &tio) < 0) {
+                fprintf(stderr, "%s: %s\n", path, strerror(errno));
+                close(fd);
+                return -1;
+        }
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cc[VMIN]  = 1;
+        tio.c_cc[VTIME] = 0;
+        if (tcsetattr(fd, TCSANOW, &tio) < 0) {
+                fprintf(stderr, "%s: %s\n", path, strerror(errno));
+                close(fd);
+                return -1;
+        }
+        tcflush(fd, TCIFLUSH);
+        return fd;
+}
+
+static void handle_frame(Stats *stats, const uint8_t *raw, size_t len) {
+        uint8_t frame[FRAME_MAX + 1];
+        int     n = cobs_decode(raw, len, frame);
+        if (n < FRAME_HEADER_SIZE + FRAME_CRC_SIZE) {
+                stats->crc_errors++;
+                fprintf(stderr, "malformed frame (%zu bytes)\n", len);
+                return;
+        }
+
+        uint16_t crc = 0xFFFF;
+        for (int i = 0; i < n - FRAME_CRC_SIZE; i++) {
+                crc = crc_ccitt_update(crc, frame[i]);
+        }
+        uint16_t expected = frame[n - 2] | (frame[n - 1] << 8);
+        if (crc != expected) {
+                stats->crc_errors++;
+                fprintf(stderr, "crc mismatch: got 0x%04X, computed 0x%04X\n", expected, crc);
+                return;
+        }
+
+        uint8_t type = frame[0];
+        uint8_t seq  = frame[1];
+        if (stats->synced && seq != stats->next_seq) {
+                uint8_t gap = seq - stats->next_seq;
+                stats->lost += gap;
+                fprintf(stderr, "lost %u frame(s) before seq %u\n", gap, seq);
+        }
+        stats->synced   = true;
+        stats->next_seq = seq + 1;
+        stats->frames++;
+
+        int payload = n - FRAME_HEADER_SIZE - FRAME_CRC_SIZE;
+        printf("%3u 0x%02X %3d:", seq, type, payload);
+        for (int i = 0; i < payload; i++) {
+                printf(" %02X", frame[FRAME_HEADER_SIZE + i]);
+        }
+        printf("\n");
+        fflush(stdout);
+}
+
+static void on_signal(int sig) {
+        (void)sig;
+        running = false;
+}
+
+int main(int argc, char **argv) {
+        if (argc > 3) {
+                fprintf(stderr, "usage: %s [device [baud]]\n", argv[0]);
+                return 1;
+        }
+        int fd = STDIN_FILENO;
+        if (argc > 1) {
+                long baud = argc > 2 ? strtol(argv[2], NULL, 10) : 115200;
+                fd        = open_port(argv[1], baud);
+                if (fd < 0) return 1;
+        }
+
+        struct sigaction sa = {.sa_handler = on_signal};
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+
+        Stats   stats = {0};
+        uint8_t raw[FRAME_MAX + 2];
+        size_t  len     = 0;
+        bool    discard = argc > 1; // a port may be opened mid frame
+        uint8_t chunk[256];
+
+        while (running) {
+                ssize_t got = read(fd, chunk, sizeof(chunk));
+                if (got < 0) {
+                        if (errno == EINTR) continue;
+                        perror("read");
+                        break;
+                }
+                if (got == 0) break;
+
+                for (ssize_t i = 0; i < got; i++) {
+                        uint8_t b = chunk[i];
+                        if (b == 0) {
+                                if (!discard && len) handle_frame(&stats, raw, len);
+                                discard = false;
+                                len     = 0;
+                        } else if (len < sizeof(raw)) {
+                                raw[len++] = b;
+                        } else {
+                                discard = true;
+                        }
+                }
+        }
+
+        fprintf(stderr, "%lu frames, %lu lost, %lu corrupt\n", stats.frames, stats.lost, stats.crc_errors);
+        if (fd != STDIN_FILENO) close(fd);
+        return 0;
+}